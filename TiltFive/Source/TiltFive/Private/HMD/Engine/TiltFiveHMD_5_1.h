@@ -22,85 +22,7 @@ void FTiltFiveXRBase::CopyTexture_RenderThread(FRHICommandListImmediate& RHICmdL
 {
 	check(IsInRenderingThread());
 
-	const uint32 ViewportWidth = DstRect.Width();
-	const uint32 ViewportHeight = DstRect.Height();
-	const FIntPoint TargetSize(ViewportWidth, ViewportHeight);
-
-	const float SrcTextureWidth = SrcTexture->GetSizeX();
-	const float SrcTextureHeight = SrcTexture->GetSizeY();
-	float U = 0.f, V = 0.f, USize = 1.f, VSize = 1.f;
-	if (!SrcRect.IsEmpty())
-	{
-		U = SrcRect.Min.X / SrcTextureWidth;
-		V = SrcRect.Min.Y / SrcTextureHeight;
-		USize = SrcRect.Width() / SrcTextureWidth;
-		VSize = SrcRect.Height() / SrcTextureHeight;
-	}
-
-	RHICmdList.Transition(FRHITransitionInfo(DstTexture, ERHIAccess::Unknown, ERHIAccess::RTV));
-
-	FRHITexture* ColorRT = DstTexture->GetTexture2D();
-	FRHIRenderPassInfo RenderPassInfo(ColorRT, ERenderTargetActions::DontLoad_Store);
-
-	RHICmdList.BeginRenderPass(RenderPassInfo, TEXT("TiltFiveHMD_CopyTexture"));
-	{
-		if (bClearBlack)
-		{
-			const FIntRect ClearRect(0, 0, DstTexture->GetSizeX(), DstTexture->GetSizeY());
-			RHICmdList.SetViewport(ClearRect.Min.X, ClearRect.Min.Y, 0, ClearRect.Max.X, ClearRect.Max.Y, 1.0f);
-			DrawClearQuad(RHICmdList, FLinearColor::Black);
-		}
-		RHICmdList.SetViewport(DstRect.Min.X, DstRect.Min.Y, 0, DstRect.Max.X, DstRect.Max.Y, 1.0f);
-
-		FGraphicsPipelineStateInitializer GraphicsPSOInit;
-		RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
-		GraphicsPSOInit.BlendState =
-			bNoAlpha
-				? TStaticBlendState<>::GetRHI()
-				: TStaticBlendState<CW_RGBA, BO_Add, BF_SourceAlpha, BF_InverseSourceAlpha, BO_Add, BF_One, BF_InverseSourceAlpha>::
-					  GetRHI();
-		GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
-		GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
-		GraphicsPSOInit.PrimitiveType = PT_TriangleList;
-
-		const auto FeatureLevel = GMaxRHIFeatureLevel;
-		auto ShaderMap = GetGlobalShaderMap(FeatureLevel);
-
-		TShaderMapRef<FScreenVS> VertexShader(ShaderMap);
-		TShaderMapRef<FScreenPS> PixelShader(ShaderMap);
-
-		GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
-		GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
-		GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
-
-		SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit, 0);
-
-		RHICmdList.Transition(FRHITransitionInfo(SrcTexture, ERHIAccess::Unknown, ERHIAccess::SRVMask));
-
-		const bool bSameSize = DstRect.Size() == SrcRect.Size();
-		if (bSameSize)
-		{
-			PixelShader->SetParameters(RHICmdList, TStaticSamplerState<SF_Point>::GetRHI(), SrcTexture);
-		}
-		else
-		{
-			PixelShader->SetParameters(RHICmdList, TStaticSamplerState<SF_Bilinear>::GetRHI(), SrcTexture);
-		}
-
-		RendererModule->DrawRectangle(RHICmdList,
-			0,
-			0,
-			ViewportWidth,
-			ViewportHeight,
-			U,
-			V,
-			USize,
-			VSize,
-			TargetSize,
-			FIntPoint(1, 1),
-			VertexShader,
-			EDRF_Default);
-	}
-	RHICmdList.EndRenderPass();
+	const FTiltFiveTextureCopy Copy{SrcTexture, SrcRect, DstRect, bNoAlpha};
+	CopyTextures_RenderThread(RHICmdList, DstTexture, MakeArrayView(&Copy, 1), bClearBlack);
 	RHICmdList.Transition(FRHITransitionInfo(DstTexture, ERHIAccess::RTV, ERHIAccess::Present));
 }
\ No newline at end of file
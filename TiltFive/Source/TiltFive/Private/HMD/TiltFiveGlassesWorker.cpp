@@ -0,0 +1,100 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "HMD/TiltFiveGlassesWorker.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "TiltFive.h"
+
+FTiltFiveGlassesWorker::FTiltFiveGlassesWorker(FT5GlassesPtr InGlasses,
+	int32 InDeviceId,
+	const TCHAR* InName,
+	EThreadPriority InPriority)
+	: Glasses(InGlasses)
+	, DeviceId(InDeviceId)
+	, Name(InName)
+	, Priority(InPriority)
+{
+}
+
+FTiltFiveGlassesWorker::~FTiltFiveGlassesWorker()
+{
+	// The derived class is already gone, so a thread still running Tick can't be stopped safely from here
+	checkf(!Thread, TEXT("%s of glasses %d was destroyed without StopAndWait"), Name, DeviceId);
+}
+
+bool FTiltFiveGlassesWorker::Start()
+{
+	check(!Thread);
+
+	OnStart();
+
+	bStopRequested = false;
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, *FString::Printf(TEXT("%s%d"), Name, DeviceId), 0, Priority);
+
+	if (!Thread)
+	{
+		UE_LOG(LogTiltFive, Error, TEXT("Failed to create %s thread for glasses %d"), Name, DeviceId);
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+void FTiltFiveGlassesWorker::StopAndWait()
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	// Kill() calls Stop() before waiting for the thread to exit
+	Thread->Kill(true);
+	delete Thread;
+	Thread = nullptr;
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+
+	OnStopped();
+}
+
+uint32 FTiltFiveGlassesWorker::Run()
+{
+	while (!bStopRequested)
+	{
+		const uint32 WaitMilliseconds = Tick();
+		if (WaitMilliseconds > 0)
+		{
+			WakeEvent->Wait(WaitMilliseconds);
+		}
+	}
+
+	return 0;
+}
+
+void FTiltFiveGlassesWorker::Stop()
+{
+	bStopRequested = true;
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
@@ -27,6 +27,7 @@
 #include "Modules/ModuleManager.h"
 #include "PipelineStateCache.h"
 #include "RendererInterface.h"
+#include "TiltFiveSettings.h"
 #include "TiltFiveXRBase.h"
 #include "XRThreadUtils.h"
 
@@ -36,9 +37,14 @@
 const FQuat rotToUGLS_GLS = FQuat(0, 0.7071068, 0, -0.7071068);
 const FQuat rotToGLS_UGLS = FQuat(0, 0.7071068, 0, 0.7071068);
 
-FTiltFiveHMD::FTiltFiveHMD(IXRTrackingSystem *inTrackingSystem, int32 inDeviceId):
+FTiltFiveHMD::FTiltFiveHMD(IXRTrackingSystem *inTrackingSystem,
+	FTiltFiveGlassesRegistry& inGlassesRegistry,
+	FTiltFiveParamWatcher& inParamWatcher,
+	int32 inDeviceId):
 	TrackingSystem(inTrackingSystem),
-	DeviceId(inDeviceId)
+	DeviceId(inDeviceId),
+	GlassesRegistry(inGlassesRegistry),
+	ParamWatcher(inParamWatcher)
 {
 	for (int32 EyeIndex = 0; EyeIndex < NumEyeRenderTargets; ++EyeIndex)
 	{
@@ -47,6 +53,7 @@ FTiltFiveHMD::FTiltFiveHMD(IXRTrackingSystem *inTrackingSystem, int32 inDeviceId
 	CachedGameboardType_GameThread = kT5_GameboardType_None;
 	CachedGameboardType_RenderThread = kT5_GameboardType_None;
 	controlledPawn = nullptr;
+	PosePredictionMode = GetDefault<UTiltFiveSettings>()->PosePredictionMode;
 }
 
 FTiltFiveHMD::~FTiltFiveHMD()
@@ -56,146 +63,387 @@ FTiltFiveHMD::~FTiltFiveHMD()
 		EyeInfos[EyeIndex].BufferedRTRHI = nullptr;
 		EyeInfos[EyeIndex].BufferedSRVRHI = nullptr;
 	}
-	t5DestroyGlasses(&CurrentExclusiveGlasses);
 	CurrentExclusiveGlasses = nullptr;
-	CurrentReservedGlasses = nullptr;
+	ReleaseConnectionGlasses();
 	controlledPawn = nullptr;
 }
 
-void FTiltFiveHMD::ConditionalInitializeGlasses()
+void FTiltFiveHMD::TickConnection_ConnectionThread(bool bAllowNewConnection)
 {
-	if (!CurrentExclusiveGlasses)
+	// Number of connection ticks we wait for reserved glasses to wake up before giving up on them
+	static constexpr int32 MaxEnsureReadyAttempts = 10;
+	// How often the connection of exclusive glasses is verified
+	static constexpr double ConnectionCheckInterval = 1.0;
+
+	const FTiltFiveModule& TiltFiveModule = FTiltFiveModule::Get();
+
+	switch (GlassesState.load())
 	{
-		if (!CurrentReservedGlasses)
+	case ETiltFiveGlassesState::Disconnected:
+	{
+		if (bAllowNewConnection && GlassesRegistry.GetSlotIdentifier(DeviceId, ConnectionGlassesIdentifier))
 		{
-			CurrentReservedGlasses = RetrieveGlasses();
+			TransitionGlassesState(ETiltFiveGlassesState::Disconnected, ETiltFiveGlassesState::Discovered);
 		}
+		break;
+	}
 
-		if (CurrentReservedGlasses)
+	case ETiltFiveGlassesState::Discovered:
+	{
+		FT5Result Result;
 		{
 			FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
-			const FTiltFiveModule& TiltFiveModule = FTiltFiveModule::Get();
-			char Identifier[T5_MAX_STRING_PARAM_LEN];
-			size_t IdentifierSize = UE_ARRAY_COUNT(Identifier);
-
-			ensure(t5GetGlassesIdentifier(CurrentReservedGlasses, Identifier, &IdentifierSize) == T5_SUCCESS);
-
-			ET5ConnectionState ConnectionState = kT5_ConnectionState_Disconnected;
-
-			// Try claiming the glasses for usage
-			//FT5Result Result = t5ReserveGlasses(CurrentReservedGlasses, TiltFiveModule.GetApplicationDisplayName());
-
-			//if (Result == T5_SUCCESS)
-			//{
-			FT5Result Result = t5GetGlassesConnectionState(CurrentReservedGlasses, &ConnectionState);
-				if (Result != T5_SUCCESS)
-				{
-					UE_LOG(LogTiltFive, Error, TEXT("Failed to get connection state: %S"), t5GetResultMessage(Result));
-				}
-
-				// If we had some old glasses, destroy them
-				if (CurrentExclusiveGlasses)
-				{
-					t5ReleaseGlasses(CurrentExclusiveGlasses);
-					t5DestroyGlasses(&CurrentExclusiveGlasses);
-					CurrentExclusiveGlasses = nullptr;
-				}
-
-				CurrentExclusiveGlasses = CurrentReservedGlasses;
-				CurrentReservedGlasses = nullptr;
-
-				int32 RetryLimit = 10;
-				for (;;)
-				{
-					Result = t5EnsureGlassesReady(CurrentExclusiveGlasses);
-					if (Result == T5_SUCCESS)
-					{
-						UE_LOG(LogTiltFive, Log, TEXT("Glasses made exclusive: %S"), Identifier);
-						break;
-					}
-					else if (RetryLimit <= 0)
-					{
-						UE_LOG(LogTiltFive,
-							Error,
-							TEXT("Failed to ensure glasses are ready and reached retry limit. "
-								"Releasing glasses."));
-						t5ReleaseGlasses(CurrentExclusiveGlasses);
-						t5DestroyGlasses(&CurrentExclusiveGlasses);
-						CurrentExclusiveGlasses = nullptr;
-						return;
-					}
-					else if (Result == T5_ERROR_TRY_AGAIN)
-					{
-						UE_LOG(LogTiltFive, Log, TEXT("Glasses not ready, trying again: %S"), Identifier);
-						RetryLimit--;
-						// Sleep for 100ms to wait for glasses to wake.
-						FPlatformProcess::SleepNoStats(0.1f);
-						continue;
-					}
-					else
-					{
-						UE_LOG(LogTiltFive,
-							Error,
-							TEXT("Failed to ensure glasses are ready. Releasing glasses.: %S"),
-							t5GetResultMessage(Result));
-						t5ReleaseGlasses(CurrentExclusiveGlasses);
-						t5DestroyGlasses(&CurrentExclusiveGlasses);
-						CurrentExclusiveGlasses = nullptr;
-						return;
-					}
-				}
-
-				const ET5GlassesParam Parameter = kT5_ParamGlasses_Float_IPD;
-
-				double IPDValue;
-
-				Result = t5GetGlassesFloatParam(CurrentExclusiveGlasses, 0, Parameter, &IPDValue);
-
-				if (Result == T5_SUCCESS)
-				{
-					bVersionCompatible = true;
-					CachedTiltFiveIPD = static_cast<float>(IPDValue);
-				}
-				else if (Result == T5_ERROR_SERVICE_INCOMPATIBLE)
-				{
-					bVersionCompatible = false;
-					UE_LOG(LogTiltFive, Error, TEXT("Version incompatible, needs service upgrade"));
-				}
-				else
-				{
-					UE_LOG(LogTiltFive, Error, TEXT("Failed to retrieve IPD Value: %S"), t5GetResultMessage(Result));
-				}
-			//}
-			/*else if (ConnectionState == kT5_ConnectionState_ExclusiveReservation)
-			{
-				UE_LOG(LogTiltFive, Verbose, TEXT("Glasses reserved: %S"), Identifier);
-			}
-			else
+			Result = t5CreateGlasses(TiltFiveModule.GetContext(), ConnectionGlassesIdentifier.Id, &ConnectionGlasses);
+		}
+		GlassesRegistry.ReportServiceResult(Result);
+
+		if (Result == T5_SUCCESS)
+		{
+			TransitionGlassesState(ETiltFiveGlassesState::Discovered, ETiltFiveGlassesState::Created);
+		}
+		else
+		{
+			// An incompatible service fails for all glasses alike and was already reported above
+			if (Result != T5_ERROR_SERVICE_INCOMPATIBLE)
 			{
 				UE_LOG(LogTiltFive,
-					Error,
-					TEXT("Failed to make glasses exclusive for glasses %S: %S"),
-					Identifier,
+					Warning,
+					TEXT("Failed to create glasses %S: %S"),
+					ConnectionGlassesIdentifier.Id,
 					t5GetResultMessage(Result));
+				GlassesRegistry.ReportGlassesUnavailable_ConnectionThread(DeviceId, ConnectionGlassesIdentifier);
+			}
+			ConnectionGlasses = nullptr;
+			TransitionGlassesState(ETiltFiveGlassesState::Discovered, ETiltFiveGlassesState::Disconnected);
+		}
+		break;
+	}
+
+	case ETiltFiveGlassesState::Created:
+	{
+		UE_LOG(LogTiltFive, Log, TEXT("Reserving glasses with ID: %S"), ConnectionGlassesIdentifier.Id);
+
+		FT5Result Result;
+		{
+			FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
+			Result = t5ReserveGlasses(ConnectionGlasses, TiltFiveModule.GetApplicationDisplayName());
+		}
 
-				// Destroy them and re-try from the beginning, potentially with other glasses
-				t5DestroyGlasses(&CurrentReservedGlasses);
-				CurrentExclusiveGlasses = nullptr;
-			}*/
+		if (Result == T5_SUCCESS)
+		{
+			UE_LOG(LogTiltFive, Log, TEXT("Reserved glasses with ID: %S"), ConnectionGlassesIdentifier.Id);
+			GlassesRegistry.ReportGlassesReserved_ConnectionThread(ConnectionGlassesIdentifier);
+			EnsureReadyAttempts = 0;
+			TransitionGlassesState(ETiltFiveGlassesState::Created, ETiltFiveGlassesState::Reserved);
 		}
+		else
+		{
+			UE_LOG(LogTiltFive,
+				Verbose,
+				TEXT("Failed to reserve glasses %S: %S"),
+				ConnectionGlassesIdentifier.Id,
+				t5GetResultMessage(Result));
+
+			// Destroy them and hand the slot back, so other glasses can take it while these cool down. Glasses reserved by another
+			// application (T5_ERROR_UNAVAILABLE) would otherwise hold the slot for as long as they are listed.
+			{
+				FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
+				t5DestroyGlasses(&ConnectionGlasses);
+			}
+			ConnectionGlasses = nullptr;
+			GlassesRegistry.ReportGlassesUnavailable_ConnectionThread(DeviceId, ConnectionGlassesIdentifier);
+			TransitionGlassesState(ETiltFiveGlassesState::Created, ETiltFiveGlassesState::Disconnected);
+		}
+		break;
 	}
-	else
+
+	case ETiltFiveGlassesState::Reserved:
 	{
-		FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
+		FT5Result Result;
+		{
+			FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
+			Result = t5EnsureGlassesReady(ConnectionGlasses);
+		}
+
+		if (Result == T5_SUCCESS)
+		{
+			UE_LOG(LogTiltFive, Log, TEXT("Glasses made exclusive: %S"), ConnectionGlassesIdentifier.Id);
+			TransitionGlassesState(ETiltFiveGlassesState::Reserved, ETiltFiveGlassesState::Ready);
+		}
+		else if (Result == T5_ERROR_TRY_AGAIN && ++EnsureReadyAttempts < MaxEnsureReadyAttempts)
+		{
+			// The glasses are still waking up, check again on the next tick
+			UE_LOG(LogTiltFive, Log, TEXT("Glasses not ready, trying again: %S"), ConnectionGlassesIdentifier.Id);
+		}
+		else
+		{
+			UE_LOG(LogTiltFive,
+				Error,
+				TEXT("Failed to ensure glasses are ready. Releasing glasses.: %S"),
+				t5GetResultMessage(Result));
+			ReleaseConnectionGlasses();
+			TransitionGlassesState(ETiltFiveGlassesState::Reserved, ETiltFiveGlassesState::Disconnected);
+		}
+		break;
+	}
+
+	case ETiltFiveGlassesState::Ready:
+	{
+		UpdateParams_ConnectionThread(true);
+		QueryNativeProjection_ConnectionThread();
+
+		PoseSampler = MakeUnique<FTiltFivePoseSampler>(ConnectionGlasses, ExclusiveGroup1CriticalSection, PoseRing, DeviceId);
+		if (!PoseSampler->Start())
+		{
+			PoseSampler.Reset();
+		}
+
+		StartWandStream_ConnectionThread();
+
+		HapticsSender = MakeUnique<FTiltFiveHapticsSender>(ConnectionGlasses, ExclusiveGroup1CriticalSection, HapticsQueue, DeviceId);
+		if (!HapticsSender->Start())
+		{
+			HapticsSender.Reset();
+		}
+
+		bReleasedByRenderThread = false;
+		LastConnectionCheckTime = FPlatformTime::Seconds();
+		TransitionGlassesState(ETiltFiveGlassesState::Ready, ETiltFiveGlassesState::Exclusive);
+		break;
+	}
+
+	case ETiltFiveGlassesState::Exclusive:
+	case ETiltFiveGlassesState::GraphicsReady:
+	{
+		UpdateParams_ConnectionThread(false);
+
+		const double CurrentTime = FPlatformTime::Seconds();
+		if (CurrentTime - LastConnectionCheckTime < ConnectionCheckInterval)
+		{
+			break;
+		}
+		LastConnectionCheckTime = CurrentTime;
+
 		ET5ConnectionState ConnectionState = kT5_ConnectionState_Disconnected;
-		const FT5Result Result = t5GetGlassesConnectionState(CurrentExclusiveGlasses, &ConnectionState);
+		FT5Result Result;
+		{
+			FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
+			Result = t5GetGlassesConnectionState(ConnectionGlasses, &ConnectionState);
+		}
+
 		if (Result != T5_SUCCESS || ConnectionState != kT5_ConnectionState_ExclusiveConnection)
 		{
 			UE_LOG(LogTiltFive, Error, TEXT("Lost connection to glasses: %S"), t5GetResultMessage(Result));
-			t5ReleaseGlasses(CurrentExclusiveGlasses);
-			t5DestroyGlasses(&CurrentExclusiveGlasses);
-			CurrentExclusiveGlasses = nullptr;
+
+			// The render thread may move the glasses from Exclusive to GraphicsReady at any time
+			ETiltFiveGlassesState CurrentState = GlassesState;
+			while (!TransitionGlassesState(CurrentState, ETiltFiveGlassesState::Lost))
+			{
+				CurrentState = GlassesState;
+			}
+		}
+		break;
+	}
+
+	case ETiltFiveGlassesState::Lost:
+	{
+		// The glasses can only be destroyed once the game thread retracted them and the render thread stopped using them
+		if (bReleasedByRenderThread)
+		{
+			ParamWatcher.ClearGlassesParams_ConnectionThread(DeviceId);
+			ReleaseConnectionGlasses();
+			TransitionGlassesState(ETiltFiveGlassesState::Lost, ETiltFiveGlassesState::Disconnected);
+		}
+		break;
+	}
+	}
+}
+
+void FTiltFiveHMD::UpdateParams_ConnectionThread(bool bReadAll)
+{
+	if (!ParamWatcher.UpdateGlassesParams_ConnectionThread(DeviceId, ConnectionGlasses, ExclusiveGroup1CriticalSection, bReadAll))
+	{
+		return;
+	}
+
+	FTiltFiveGlassesParams Params;
+	if (ParamWatcher.GetGlassesParams(DeviceId, Params) && Params.IPD > 0.0f)
+	{
+		CachedTiltFiveIPD = Params.IPD;
+	}
+}
+
+void FTiltFiveHMD::QueryNativeProjection_ConnectionThread()
+{
+	// Only the framebuffer size and field of view are used, the matrix itself is built with the engine's conventions by
+	// FTiltFiveProjectionCache. The clip planes merely have to be valid.
+	T5_ProjectionInfo ProjectionInfo;
+	FT5Result Result;
+	{
+		FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
+		Result = t5GetProjection(ConnectionGlasses,
+			kT5_CartesianCoordinateHandedness_Left,
+			kT5_DepthRange_ZeroToOne,
+			kT5_MatrixOrder_RowMajor,
+			0.1,
+			100.0,
+			1.0,
+			&ProjectionInfo);
+	}
+
+	if (Result != T5_SUCCESS)
+	{
+		UE_LOG(LogTiltFive, Warning, TEXT("Failed to get projection for glasses %d, using defaults: %S"), DeviceId,
+			t5GetResultMessage(Result));
+		return;
+	}
+
+	if (ProjectionInfo.framebufferWidth == 0 || ProjectionInfo.framebufferHeight == 0 || ProjectionInfo.fieldOfView <= 0.0 ||
+		ProjectionInfo.aspectRatio <= 0.0)
+	{
+		UE_LOG(LogTiltFive, Warning, TEXT("Glasses %d reported an invalid projection, using defaults"), DeviceId);
+		return;
+	}
+
+	// The service reports the vertical field of view, FOV is the horizontal one
+	const double HalfVerticalFovTan = FMath::Tan(FMath::DegreesToRadians(ProjectionInfo.fieldOfView) / 2.0);
+	const double HorizontalFOV = FMath::RadiansToDegrees(FMath::Atan(HalfVerticalFovTan * ProjectionInfo.aspectRatio) * 2.0);
+
+	NativeHorizontalFOV = (float)HorizontalFOV;
+	NativeEyeSize = ((uint32)ProjectionInfo.framebufferWidth << 16) | (uint32)ProjectionInfo.framebufferHeight;
+
+	UE_LOG(LogTiltFive, Log, TEXT("Glasses %d render at %dx%d per eye with a %.1f degree horizontal field of view"), DeviceId,
+		ProjectionInfo.framebufferWidth, ProjectionInfo.framebufferHeight, HorizontalFOV);
+}
+
+bool FTiltFiveHMD::GetNativeEyeSize(FIntPoint& OutEyeSize) const
+{
+	const uint32 PackedEyeSize = NativeEyeSize;
+	if (PackedEyeSize == 0)
+	{
+		return false;
+	}
+
+	OutEyeSize = FIntPoint(PackedEyeSize >> 16, PackedEyeSize & 0xFFFF);
+	return true;
+}
+
+bool FTiltFiveHMD::TransitionGlassesState(ETiltFiveGlassesState FromState, ETiltFiveGlassesState ToState)
+{
+	if (!GlassesState.compare_exchange_strong(FromState, ToState))
+	{
+		return false;
+	}
+
+	StateTransitions.Enqueue({FromState, ToState});
+	return true;
+}
+
+bool FTiltFiveHMD::DequeueStateTransition(FTiltFiveGlassesStateTransition& OutTransition)
+{
+	return StateTransitions.Dequeue(OutTransition);
+}
+
+void FTiltFiveHMD::ApplyStateTransition_GameThread(ETiltFiveGlassesState NewState)
+{
+	check(IsInGameThread());
+
+	if (NewState == ETiltFiveGlassesState::Exclusive)
+	{
+		// The connection thread doesn't touch the glasses handle again until the glasses are lost
+		CurrentExclusiveGlasses = ConnectionGlasses;
+
+		const float NativeFOV = NativeHorizontalFOV;
+		if (!bFOVOverridden && NativeFOV > 0.0f)
+		{
+			FOV = NativeFOV;
 		}
+		ExecuteOnRenderThread_DoNotWait(
+			[Self = AsShared(), Glasses = CurrentExclusiveGlasses](FRHICommandListImmediate& RHICmdList)
+			{
+				Self->ExclusiveGlasses_RenderThread = Glasses;
+			});
+	}
+	else if (NewState == ETiltFiveGlassesState::Lost)
+	{
+		CurrentExclusiveGlasses = nullptr;
+		ExecuteOnRenderThread_DoNotWait(
+			[Self = AsShared()](FRHICommandListImmediate& RHICmdList)
+			{
+				Self->ExclusiveGlasses_RenderThread = nullptr;
+				Self->MaybeRelativeGlassesTransform_RenderThread.Reset();
+
+				// Frames already handed to the RHI thread may still be sent to the glasses, so release them from there
+				RHICmdList.EnqueueLambda(
+					[Self](FRHICommandListImmediate&)
+					{
+						Self->GraphicsInitializedGlasses = nullptr;
+						Self->bReleasedByRenderThread = true;
+					});
+			});
+	}
+}
+
+void FTiltFiveHMD::NotifyGraphicsInitialized_RenderThread()
+{
+	TransitionGlassesState(ETiltFiveGlassesState::Exclusive, ETiltFiveGlassesState::GraphicsReady);
+}
+
+void FTiltFiveHMD::ReleaseConnectionGlasses()
+{
+	if (WandStreamReader)
+	{
+		WandStreamReader->StopAndWait();
+		WandStreamReader.Reset();
+	}
+
+	// The sampler and the haptics sender take the group 1 lock themselves, so they have to be stopped before we take it below
+	if (HapticsSender)
+	{
+		HapticsSender->StopAndWait();
+		HapticsSender.Reset();
+	}
+
+	if (PoseSampler)
+	{
+		PoseSampler->StopAndWait();
+		PoseSampler.Reset();
+	}
+
+	if (!ConnectionGlasses)
+	{
+		return;
+	}
+
+	FScopeLock GraphicsScopeLock(&ExclusiveGroup3CriticalSection);
+	FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
+	t5ReleaseGlasses(ConnectionGlasses);
+	t5DestroyGlasses(&ConnectionGlasses);
+	ConnectionGlasses = nullptr;
+}
+
+void FTiltFiveHMD::StartWandStream_ConnectionThread()
+{
+	FT5WandStreamConfig WandStreamConfig;
+	WandStreamConfig.enabled = true;
+
+	FT5Result Result;
+	{
+		FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
+		Result = t5ConfigureWandStreamForGlasses(ConnectionGlasses, &WandStreamConfig);
+	}
+
+	if (Result != T5_SUCCESS)
+	{
+		UE_LOG(LogTiltFive, Error, TEXT("Failed to configure wand stream: %S"), t5GetResultMessage(Result));
+		return;
+	}
+
+	WandStreamReader = MakeUnique<FTiltFiveWandStreamReader>(
+		ConnectionGlasses, ExclusiveGroup2CriticalSection, WandEventQueue, WandPoseRings, DeviceId);
+	if (!WandStreamReader->Start())
+	{
+		WandStreamReader.Reset();
 	}
 }
 
@@ -248,55 +496,13 @@ FVector FTiltFiveHMD::ConvertToHardware(const FVector& Location, float WorldToMe
 
 bool FTiltFiveHMD::IsHMDConnected()
 {
-	if (CurrentExclusiveGlasses != nullptr)
-	{
-		return true;
-	}
-	else {
-		const FTiltFiveModule& TiltFiveModule = FTiltFiveModule::Get();
-		FT5GlassesPtr NewGlasses = nullptr;
-		TArray<char, TFixedAllocator<FTiltFiveXRBase::GMaxNumTiltFiveGlasses * T5_MAX_STRING_PARAM_LEN>> GlassesStringBuffer;
-		SIZE_T BufferSize = FTiltFiveXRBase::GMaxNumTiltFiveGlasses * T5_MAX_STRING_PARAM_LEN;
-
-		{
-			FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
-			const FT5Result Result = t5ListGlasses(TiltFiveModule.GetContext(), GlassesStringBuffer.GetData(), &BufferSize);
-
-			GlassesStringBuffer.SetNumUnsafeInternal(BufferSize);
-
-			TArray<FString> Glasses;
-
-			char* CurrentPosition = GlassesStringBuffer.GetData();
-			bool bMoreGlasses = true;
-			do
-			{
-				const int32 Length = FCStringAnsi::Strlen(CurrentPosition);
-
-				if (Length > 0)
-				{
-					Glasses.Add(FString(CurrentPosition));
-					CurrentPosition += Length + 1;
-				}
-				else
-				{
-					bMoreGlasses = false;
-				}
-			} while (bMoreGlasses);
-
-			if (Result == T5_ERROR_SERVICE_INCOMPATIBLE)
-			{
-				bVersionCompatible = false;
-				UE_LOG(LogTiltFive, Error, TEXT("Version incompatible, needs service upgrade"));
-			}
-			bVersionCompatible = true;
-			return Result == T5_SUCCESS && BufferSize > 0 && Glasses.Num() > DeviceId;
-		}
-	}
+	// The registry lists the glasses for all players in the background, so this is cheap enough to call every frame
+	return CurrentExclusiveGlasses != nullptr || GlassesRegistry.IsSlotOccupied(DeviceId);
 }
 
 bool FTiltFiveHMD::IsHMDEnabled() const
 {
-	return CurrentExclusiveGlasses != nullptr;
+	return (IsInRenderingThread() ? ExclusiveGlasses_RenderThread : CurrentExclusiveGlasses) != nullptr;
 }
 
 void FTiltFiveHMD::EnableHMD(bool bEnable /*= true*/)
@@ -350,17 +556,15 @@ bool FTiltFiveHMD::GetHMDDistortionEnabled(EShadingPath ShadingPath) const
 
 FIntPoint FTiltFiveHMD::GetIdealRenderTargetSize() const
 {
-	return FIntPoint(2432, 3072);
+	// All glasses share one render target, sized for the players that are currently rendered
+	return static_cast<const FTiltFiveXRBase*>(TrackingSystem)->GetAtlasLayout().GetSize();
 }
 
 #if UE_VERSION_NEWER_THAN(4, 20, 3)
 FIntPoint FTiltFiveHMD::GetIdealDebugCanvasRenderTargetSize() const
 {
-	FIntPoint Result = GetIdealRenderTargetSize();
 	// Only one eye
-	Result.X /= 2;
-	Result.Y /= 4;
-	return Result;
+	return static_cast<const FTiltFiveXRBase*>(TrackingSystem)->GetAtlasLayout().EyeSize;
 }
 #endif
 
@@ -379,6 +583,51 @@ bool FTiltFiveHMD::GetUseImplicitHMDPosition() const {
 
 void FTiltFiveHMD::OverrideFOV(float& InOutFOV) {
 	FOV = InOutFOV;
+	bFOVOverridden = true;
+}
+
+const FTiltFiveProjection& FTiltFiveProjectionCache::Get(float FOV, const FIntPoint& EyeSize, float NearPlane)
+{
+	if (FOV == CachedFOV && EyeSize == CachedEyeSize && NearPlane == CachedNearPlane)
+	{
+		return Projection;
+	}
+	CachedFOV = FOV;
+	CachedEyeSize = EyeSize;
+	CachedNearPlane = NearPlane;
+	++NumUpdates;
+
+	const float HalfFovTan = FMath::Tan(FMath::DegreesToRadians(FOV) / 2.f);
+	const float WidthToHeight = EyeSize.Y > 0 ? (float)EyeSize.X / (float)EyeSize.Y : 1.0f;
+	const float XS = 1.0f / HalfFovTan;
+	const float YS = XS * WidthToHeight;
+
+	Projection.ProjectionMatrix = FMatrix(FPlane(XS, 0.0f, 0.0f, 0.0f),
+		FPlane(0.0f, YS, 0.0f, 0.0f),
+		FPlane(0.0f, 0.0f, 0.0f, 1.0f),
+		FPlane(0.0f, 0.0f, NearPlane, 0.0f));
+
+	Projection.StartX_VCI = -HalfFovTan;
+	Projection.StartY_VCI = Projection.StartX_VCI / WidthToHeight;
+	Projection.Width_VCI = -2.0f * Projection.StartX_VCI;
+	Projection.Height_VCI = -2.0f * Projection.StartY_VCI;
+
+	return Projection;
+}
+
+const FTiltFiveProjection& FTiltFiveHMD::GetProjection() const
+{
+	// Both eyes always have the same size
+	const FIntPoint EyeSize = static_cast<const FTiltFiveXRBase*>(TrackingSystem)->GetAtlasLayout().EyeSize;
+
+	// The render thread uses the FOV the game thread rendered the frame with
+	if (IsInRenderingThread())
+	{
+		const float FrameFOV = FrameState_RenderThread ? FrameState_RenderThread->Glasses[DeviceId].FOV : FOV;
+		return ProjectionCache_RenderThread.Get(FrameFOV, EyeSize, ::GNearClippingPlane);
+	}
+
+	return ProjectionCache_GameThread.Get(FOV, EyeSize, ::GNearClippingPlane);
 }
 
 void FTiltFiveHMD::SetupLateUpdate(const FTransform& ParentToWorld, USceneComponent* Component, bool bSkipLateUpdate) {
@@ -387,14 +636,14 @@ void FTiltFiveHMD::SetupLateUpdate(const FTransform& ParentToWorld, USceneCompon
 
 float FTiltFiveHMD::GetWorldToMetersScale() const
 {
-	FTiltFiveWorldStatePtr CurrentState;
+	const FTiltFiveFrameState* CurrentState;
 	if (IsInRenderingThread())
 	{
-		CurrentState = RenderThreadWorldState;
+		CurrentState = FrameState_RenderThread;
 	}
 	else if (IsInGameThread())
 	{
-		CurrentState = CurrentWorldState;
+		CurrentState = FrameState_GameThread;
 	}
 	else
 	{
@@ -402,7 +651,7 @@ float FTiltFiveHMD::GetWorldToMetersScale() const
 		return 100.0f;
 	}
 
-	if (!CurrentState.IsValid())
+	if (!CurrentState || !CurrentState->bHasWorldToMetersScale)
 	{
 		// Fallback to default value
 		return 100.0f;
@@ -506,24 +755,21 @@ void FTiltFiveHMD::UpdateCachedGlassesPose_RenderThread()
 {
 	check(IsInRenderingThread());
 
-	if (!RenderThreadWorldState.IsValid())
+	if (!FrameState_RenderThread || !FrameState_RenderThread->bHasWorldToMetersScale)
 	{
 		CachedGlassesPoseIsValid_RenderThread = false;
 		return;
 	}
 
-	FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
-
 	FT5GlassesPose Pose;
 
-	const FT5Result Result = t5GetGlassesPose(CurrentExclusiveGlasses, kT5_GlassesPoseUsage_GlassesPresentation, &Pose);
-
-	if (Result == T5_SUCCESS)
+	if (PosePredictor_RenderThread.Predict(PosePredictionMode, PoseRing, EstimatedRenderThreadLatencySeconds, Pose))
 	{
 		CachedGlassesPoseIsValid_RenderThread = true;
+		CachedGlassesPoseTime_RenderThread = FPlatformTime::Seconds();
 		CachedGlassesOrientation_RenderThread = ConvertRotationFromHardware(Pose.rotToGLS_GBD);
 		CachedGlassesPosition_RenderThread =
-			ConvertPositionFromHardware(Pose.posGLS_GBD, RenderThreadWorldState->WorldToMetersScale);
+			ConvertPositionFromHardware(Pose.posGLS_GBD, FrameState_RenderThread->WorldToMetersScale);
 		CachedGameboardType_RenderThread = Pose.gameboardType;
 	}
 	else
@@ -532,126 +778,147 @@ void FTiltFiveHMD::UpdateCachedGlassesPose_RenderThread()
 	}
 }
 
-void FTiltFiveHMD::UpdateCachedGlassesPose_GameThread()
+bool FTiltFiveHMD::PredictWandPose_RenderThread(FT5WandHandle WandHandle, FQuat& OutOrientation, FVector& OutPosition)
 {
-	check(IsInGameThread());
+	check(IsInRenderingThread());
 
-	if (!CurrentWorldState.IsValid())
+	const int32 RingIndex = WandPoseRings.FindRing(WandHandle);
+	if (RingIndex == INDEX_NONE)
 	{
-		CachedGlassesPoseIsValid_GameThread = false;
-		return;
+		return false;
 	}
 
-	FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
+	FTiltFivePosePredictor& Predictor = WandPosePredictors_RenderThread[RingIndex];
+	if (WandPosePredictorHandles_RenderThread[RingIndex] != WandHandle)
+	{
+		Predictor.Reset();
+		WandPosePredictorHandles_RenderThread[RingIndex] = WandHandle;
+	}
 
 	FT5GlassesPose Pose;
+	if (!Predictor.Predict(PosePredictionMode, WandPoseRings.Rings[RingIndex], EstimatedRenderThreadLatencySeconds, Pose) ||
+		WandPoseRings.FindRing(WandHandle) != RingIndex)
+	{
+		return false;
+	}
 
-	const FT5Result Result = t5GetGlassesPose(CurrentExclusiveGlasses, kT5_GlassesPoseUsage_GlassesPresentation, &Pose);
+	OutOrientation = ConvertRotationFromHardware(Pose.rotToGLS_GBD);
+	OutPosition = ConvertPositionFromHardware(Pose.posGLS_GBD, 1.0f);
+	return true;
+}
 
-	if (Result == T5_SUCCESS)
+bool FTiltFiveHMD::SampleWandMotion(FT5WandHandle WandHandle, double TimeSeconds, FTiltFiveWandMotion& OutMotion) const
+{
+	const int32 RingIndex = WandPoseRings.FindRing(WandHandle);
+	if (RingIndex == INDEX_NONE)
 	{
-		CachedGlassesPoseIsValid_GameThread = true;
-		CachedGlassesOrientation_GameThread = ConvertRotationFromHardware(Pose.rotToGLS_GBD);
-		CachedGlassesPosition_GameThread = ConvertPositionFromHardware(Pose.posGLS_GBD, CurrentWorldState->WorldToMetersScale);
-		CachedGameboardType_GameThread = Pose.gameboardType;
+		return false;
 	}
-	else
+
+	FTiltFivePoseSample History[FTiltFivePosePredictor::MaxHistory];
+	const int32 NumSamples =
+		FTiltFivePosePredictor::ReadHistory(WandPoseRings.Rings[RingIndex], History, FTiltFivePosePredictor::MaxHistory);
+	if (NumSamples == 0 || WandPoseRings.FindRing(WandHandle) != RingIndex)
 	{
-		CachedGlassesPoseIsValid_GameThread = false;
+		return false;
 	}
-}
 
-FT5GlassesPtr FTiltFiveHMD::RetrieveGlasses() const
-{
-	FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
-	static int32 CurrentGlassesIndex = 0;
-	const FTiltFiveModule& TiltFiveModule = FTiltFiveModule::Get();
+	OutMotion = FTiltFiveWandMotion();
+	OutMotion.Position = ConvertPositionFromHardware(History[0].Pose.posGLS_GBD, 1.0f);
+	OutMotion.Orientation = ConvertRotationFromHardware(History[0].Pose.rotToGLS_GBD);
+	if (NumSamples == 1)
+	{
+		return true;
+	}
 
-	FT5GlassesPtr NewGlasses = nullptr;
-	TArray<char, TFixedAllocator<FTiltFiveXRBase::GMaxNumTiltFiveGlasses * T5_MAX_STRING_PARAM_LEN>> GlassesStringBuffer;
-	SIZE_T BufferSize = FTiltFiveXRBase::GMaxNumTiltFiveGlasses * T5_MAX_STRING_PARAM_LEN;
+	// The requested time is on our clock, the samples are on the service clock. The newest sample was read on both.
+	const double NewestHostSeconds = FPlatformTime::ToSeconds64(History[0].HostCycles);
+	const int64 TargetNanos =
+		static_cast<int64>(History[0].Pose.timestampNanos) + static_cast<int64>((TimeSeconds - NewestHostSeconds) * 1e9);
 
-	FT5Result Result = t5ListGlasses(TiltFiveModule.GetContext(), GlassesStringBuffer.GetData(), &BufferSize);
+	// The pair of samples around the requested time, or the newest or oldest pair if it's outside the history
+	int32 NewerIndex = 0;
+	while (NewerIndex + 2 < NumSamples && static_cast<int64>(History[NewerIndex + 1].Pose.timestampNanos) > TargetNanos)
+	{
+		++NewerIndex;
+	}
+	const FT5GlassesPose& Older = History[NewerIndex + 1].Pose;
+	const FT5GlassesPose& Newer = History[NewerIndex].Pose;
 
-	if (Result == T5_SUCCESS)
+	const double SpanSeconds = static_cast<double>(static_cast<int64>(Newer.timestampNanos - Older.timestampNanos)) * 1e-9;
+
+	// Reports can share a timestamp, there is no motion to tell between those
+	if (SpanSeconds <= 0.0)
 	{
-		
-		bVersionCompatible = true;
-		// Now figure out the number of glasses of this string mess
-		GlassesStringBuffer.SetNumUnsafeInternal(BufferSize);
+		OutMotion.Position = ConvertPositionFromHardware(Newer.posGLS_GBD, 1.0f);
+		OutMotion.Orientation = ConvertRotationFromHardware(Newer.rotToGLS_GBD);
+		return true;
+	}
 
-		TArray<FString> Glasses;
+	const double OffsetSeconds = static_cast<double>(TargetNanos - static_cast<int64>(Older.timestampNanos)) * 1e-9;
 
-		char* CurrentPosition = GlassesStringBuffer.GetData();
-		bool bMoreGlasses = true;
-		do
-		{
-			const int32 Length = FCStringAnsi::Strlen(CurrentPosition);
+	// Never extrapolate further than the glasses would be predicted, and hold the oldest pose for times before the history
+	const double Alpha = FMath::Clamp(OffsetSeconds, 0.0, SpanSeconds + FTiltFivePosePredictor::MaxHorizonSeconds) / SpanSeconds;
 
-			if (Length > 0)
-			{
-				Glasses.Add(FString(CurrentPosition));
-				CurrentPosition += Length + 1;
-			}
-			else
-			{
-				bMoreGlasses = false;
-			}
-		} while (bMoreGlasses);
-		if (DeviceId < Glasses.Num())
-		{
-			Result = t5CreateGlasses(
-				TiltFiveModule.GetContext(), TCHAR_TO_UTF8(*Glasses[CurrentGlassesIndex % Glasses.Num()]), &NewGlasses);
+	const FVector OlderPosition = ConvertPositionFromHardware(Older.posGLS_GBD, 1.0f);
+	const FVector NewerPosition = ConvertPositionFromHardware(Newer.posGLS_GBD, 1.0f);
+	const FQuat OlderOrientation = ConvertRotationFromHardware(Older.rotToGLS_GBD);
+	FQuat Delta = ConvertRotationFromHardware(Newer.rotToGLS_GBD) * OlderOrientation.Inverse();
+	Delta.EnforceShortestArcWith(FQuat::Identity);
+	const FVector DeltaAxis = Delta.GetRotationAxis();
+	const float DeltaAngle = Delta.GetAngle();
 
-			if (Result == T5_SUCCESS)
-			{
-				bVersionCompatible = true;
-				UE_LOG(LogTiltFive, Log, TEXT("Reserving glasses with ID: %s"), *Glasses[CurrentGlassesIndex % Glasses.Num()]);
-
-				Result = t5ReserveGlasses(NewGlasses, TiltFiveModule.GetApplicationDisplayName());
-
-				if (Result == T5_SUCCESS)
-				{
-					UE_LOG(LogTiltFive, Log, TEXT("Reserved glasses with ID: %s"), *Glasses[CurrentGlassesIndex % Glasses.Num()]);
-				}
-				else
-				{
-					//UE_LOG(LogTiltFive, Error, TEXT("Failed to reserve glasses %S: %S"), *Glasses[CurrentGlassesIndex % Glasses.Num()], t5GetResultMessage(Result));
-
-					// Destroy them and re-try from the beginning, potentially with other glasses
-					t5DestroyGlasses(&NewGlasses);
-					NewGlasses = nullptr;
-				}
-			}
-			else if (Result == T5_ERROR_SERVICE_INCOMPATIBLE)
-			{
-				bVersionCompatible = false;
-				UE_LOG(LogTiltFive, Error, TEXT("Version incompatible, needs service upgrade"));
-			}
-		}
-		else
-		{
-			UE_LOG(LogTiltFive, VeryVerbose, TEXT("No glasses connected..."));
-		}
+	OutMotion.Position = FMath::Lerp(OlderPosition, NewerPosition, Alpha);
+	OutMotion.Orientation = (FQuat(DeltaAxis, DeltaAngle * Alpha) * OlderOrientation).GetNormalized();
+	OutMotion.LinearVelocity = (NewerPosition - OlderPosition) / SpanSeconds;
+	OutMotion.AngularVelocity = DeltaAxis * (DeltaAngle / SpanSeconds);
+	return true;
+}
+
+void FTiltFiveHMD::UpdateCachedGlassesPose_GameThread()
+{
+	check(IsInGameThread());
+
+	if (!FrameState_GameThread || !FrameState_GameThread->bHasWorldToMetersScale)
+	{
+		CachedGlassesPoseIsValid_GameThread = false;
+		return;
 	}
-	else if (Result == T5_ERROR_SERVICE_INCOMPATIBLE)
+
+	FT5GlassesPose Pose;
+
+	if (PosePredictor_GameThread.Predict(PosePredictionMode, PoseRing, EstimatedGameThreadLatencySeconds, Pose))
 	{
-		bVersionCompatible = false;
-		UE_LOG(LogTiltFive, Error, TEXT("Version incompatible, needs service upgrade"));
+		CachedGlassesPoseIsValid_GameThread = true;
+		CachedGlassesPoseTime_GameThread = FPlatformTime::Seconds();
+		CachedGlassesOrientation_GameThread = ConvertRotationFromHardware(Pose.rotToGLS_GBD);
+		CachedGlassesPosition_GameThread = ConvertPositionFromHardware(Pose.posGLS_GBD, FrameState_GameThread->WorldToMetersScale);
+		CachedGameboardType_GameThread = Pose.gameboardType;
 	}
 	else
 	{
-		// T5_ERROR_NO_SERVICE or T5_ERROR_IO_FAILURE apparently means it is starting up internally,
-		// and we get it soon(tm)
-		UE_CLOG(Result != T5_ERROR_NO_SERVICE && Result != T5_ERROR_IO_FAILURE,
-			LogTiltFive,
-			Error,
-			TEXT("Failed to retrieve glasses: %S"),
-			t5GetResultMessage(Result));
+		CachedGlassesPoseIsValid_GameThread = false;
 	}
+}
+
+void FTiltFiveHMD::UpdateLatencyEstimates(double FrameSentTime, double RenderThreadPoseTime, double GameThreadPoseTime)
+{
+	// Smoothing factor of the latency estimates; frame times vary a lot more than the latency we're trying to track
+	static constexpr float LatencySmoothing = 0.1f;
+	static constexpr float MaxLatencySeconds = 0.1f;
 
-	// Next time, try the next index
-	++CurrentGlassesIndex;
+	const float DisplayLatencySeconds = GetDefault<UTiltFiveSettings>()->PosePredictionDisplayLatency / 1000.0f;
+	const auto UpdateEstimate = [&](std::atomic<float>& Estimate, double PoseTime)
+	{
+		if (PoseTime <= 0.0)
+		{
+			return;
+		}
+		const float Latency =
+			FMath::Clamp(static_cast<float>(FrameSentTime - PoseTime) + DisplayLatencySeconds, 0.0f, MaxLatencySeconds);
+		Estimate = FMath::Lerp(Estimate.load(), Latency, LatencySmoothing);
+	};
 
-	return NewGlasses;
+	UpdateEstimate(EstimatedRenderThreadLatencySeconds, RenderThreadPoseTime);
+	UpdateEstimate(EstimatedGameThreadLatencySeconds, GameThreadPoseTime);
 }
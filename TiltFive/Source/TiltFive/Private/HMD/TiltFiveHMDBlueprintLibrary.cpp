@@ -70,17 +70,52 @@ void UTiltFiveHMDBlueprintLibrary::SetSpectatedPlayer(int32 playerIndex)
 	return;
 }
 
+void UTiltFiveHMDBlueprintLibrary::SetSpectatorLayout(const FTiltFiveSpectatorLayout& Layout)
+{
+	FTiltFiveModule::Get().GetHMD()->SetSpectatorLayout(Layout);
+}
+
+void UTiltFiveHMDBlueprintLibrary::SetPosePredictionMode(int32 playerIndex, ETiltFivePosePredictionMode Mode)
+{
+	if (playerIndex < 0 || playerIndex >= FTiltFiveXRBase::GMaxNumTiltFiveGlasses)
+	{
+		UE_LOG(LogTiltFive, Error, TEXT("Invalid player index %d"), playerIndex);
+		return;
+	}
+	FTiltFiveModule::Get().GetHMD()->GlassesList[playerIndex]->PosePredictionMode = Mode;
+}
+
+ETiltFivePosePredictionMode UTiltFiveHMDBlueprintLibrary::GetPosePredictionMode(int32 playerIndex)
+{
+	if (playerIndex < 0 || playerIndex >= FTiltFiveXRBase::GMaxNumTiltFiveGlasses)
+	{
+		return ETiltFivePosePredictionMode::Disabled;
+	}
+	return FTiltFiveModule::Get().GetHMD()->GlassesList[playerIndex]->PosePredictionMode;
+}
+
 bool UTiltFiveHMDBlueprintLibrary::IsTiltFiveUiRequestingAttention()
 {
-	int64_t value = 0;
+	FTiltFiveSystemParams Params;
+	return FTiltFiveModule::Get().GetHMD()->ParamWatcher.GetSystemParams(Params) && Params.bUiRequestingAttention;
+}
 
-	T5_Result result = t5GetSystemIntegerParam(FTiltFiveModule::Get().GetContext(), kT5_ParamSys_Integer_CPL_AttRequired, &value);
-	if (result == T5_SUCCESS)
+FString UTiltFiveHMDBlueprintLibrary::GetServiceVersion()
+{
+	FTiltFiveSystemParams Params;
+	if (!FTiltFiveModule::Get().GetHMD()->ParamWatcher.GetSystemParams(Params))
 	{
-		return value != 0;
+		return FString();
 	}
-	else
+	return FString(UTF8_TO_TCHAR(Params.ServiceVersion));
+}
+
+FString UTiltFiveHMDBlueprintLibrary::GetGlassesFriendlyName(int32 playerIndex)
+{
+	FTiltFiveGlassesParams Params;
+	if (!FTiltFiveModule::Get().GetHMD()->ParamWatcher.GetGlassesParams(playerIndex, Params))
 	{
-		return false;
+		return FString();
 	}
+	return FString(UTF8_TO_TCHAR(Params.FriendlyName));
 }
@@ -0,0 +1,270 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "HMD/TiltFiveHaptics.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "TiltFive.h"
+#include "TiltFiveStats.h"
+
+DEFINE_STAT(STAT_TiltFiveHapticsSent);
+DEFINE_STAT(STAT_TiltFiveHapticsMerged);
+DEFINE_STAT(STAT_TiltFiveHapticsDropped);
+
+// Shortest time between two impulses sent to the same wand. Every impulse is a round trip to the service, and requests usually
+// come in every frame while an effect plays.
+static constexpr double MinSendIntervalSeconds = 1.0 / 60.0;
+
+// A new impulse is merged into the one the wand is playing if it isn't stronger and ends at most this much later. Keeps effects
+// that are refreshed every frame from being resent every frame.
+static constexpr double MergeSlackSeconds = 0.05;
+
+// How long the sender sleeps while there is nothing to send. Requests wake it up earlier.
+static constexpr uint32 IdleWaitMilliseconds = 100;
+
+FTiltFiveHapticsQueue::FTiltFiveHapticsQueue()
+{
+	RequestEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FTiltFiveHapticsQueue::~FTiltFiveHapticsQueue()
+{
+	FPlatformProcess::ReturnSynchEventToPool(RequestEvent);
+	RequestEvent = nullptr;
+}
+
+void FTiltFiveHapticsQueue::Request(FT5WandHandle Wand, float Amplitude, uint32 DurationMilliseconds)
+{
+	if (Amplitude <= 0.0f || DurationMilliseconds == 0)
+	{
+		return;
+	}
+
+	const FTiltFiveHapticImpulse Impulse{Wand,
+		FMath::Min(Amplitude, 1.0f),
+		FPlatformTime::Seconds() + FMath::Min(DurationMilliseconds, uint32(MaxDurationMilliseconds)) / 1000.0};
+
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+
+		FTiltFiveHapticImpulse* Existing = nullptr;
+		for (int32 Index = 0; Index < NumWaiting; ++Index)
+		{
+			if (Waiting[Index].Wand == Wand)
+			{
+				Existing = &Waiting[Index];
+			}
+		}
+
+		if (Existing)
+		{
+			Existing->Amplitude = FMath::Max(Existing->Amplitude, Impulse.Amplitude);
+			Existing->EndSeconds = FMath::Max(Existing->EndSeconds, Impulse.EndSeconds);
+			INC_DWORD_STAT(STAT_TiltFiveHapticsMerged);
+			return;
+		}
+
+		if (NumWaiting == MaxWands)
+		{
+			INC_DWORD_STAT(STAT_TiltFiveHapticsDropped);
+			return;
+		}
+
+		Waiting[NumWaiting++] = Impulse;
+	}
+
+	RequestEvent->Trigger();
+}
+
+int32 FTiltFiveHapticsQueue::TakeAll(FTiltFiveHapticImpulse (&OutImpulses)[MaxWands])
+{
+	FScopeLock ScopeLock(&CriticalSection);
+
+	const int32 NumTaken = NumWaiting;
+	for (int32 Index = 0; Index < NumTaken; ++Index)
+	{
+		OutImpulses[Index] = Waiting[Index];
+	}
+	NumWaiting = 0;
+	return NumTaken;
+}
+
+void FTiltFiveHapticsQueue::Clear()
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	NumWaiting = 0;
+}
+
+void FTiltFiveHapticsQueue::Wait(uint32 WaitMilliseconds)
+{
+	RequestEvent->Wait(WaitMilliseconds);
+}
+
+void FTiltFiveHapticsQueue::Wake()
+{
+	RequestEvent->Trigger();
+}
+
+FTiltFiveHapticsSender::FTiltFiveHapticsSender(FT5GlassesPtr InGlasses,
+	FCriticalSection& InExclusiveGroup1CriticalSection,
+	FTiltFiveHapticsQueue& InQueue,
+	int32 InDeviceId)
+	: FTiltFiveGlassesWorker(InGlasses, InDeviceId, TEXT("TiltFiveHaptics"), TPri_Normal)
+	, ExclusiveGroup1CriticalSection(InExclusiveGroup1CriticalSection)
+	, Queue(InQueue)
+{
+}
+
+void FTiltFiveHapticsSender::OnStart()
+{
+	// Whatever was requested while the glasses were away is stale by now
+	Queue.Clear();
+}
+
+void FTiltFiveHapticsSender::Stop()
+{
+	FTiltFiveGlassesWorker::Stop();
+	Queue.Wake();
+}
+
+uint32 FTiltFiveHapticsSender::Tick()
+{
+	FTiltFiveHapticImpulse Impulses[FTiltFiveHapticsQueue::MaxWands];
+	const int32 NumImpulses = Queue.TakeAll(Impulses);
+	for (int32 Index = 0; Index < NumImpulses; ++Index)
+	{
+		FWandState& WandState = FindOrAddWand(Impulses[Index].Wand);
+		if (WandState.bHasPending)
+		{
+			WandState.Pending.Amplitude = FMath::Max(WandState.Pending.Amplitude, Impulses[Index].Amplitude);
+			WandState.Pending.EndSeconds = FMath::Max(WandState.Pending.EndSeconds, Impulses[Index].EndSeconds);
+			INC_DWORD_STAT(STAT_TiltFiveHapticsMerged);
+		}
+		else
+		{
+			WandState.Pending = Impulses[Index];
+			WandState.bHasPending = true;
+		}
+	}
+
+	const double NowSeconds = FPlatformTime::Seconds();
+	double NextSendSeconds = 0.0;
+	for (FWandState& WandState : WandStates)
+	{
+		const double WandNextSendSeconds = SendPending(WandState, NowSeconds);
+		if (WandNextSendSeconds > 0.0 && (NextSendSeconds == 0.0 || WandNextSendSeconds < NextSendSeconds))
+		{
+			NextSendSeconds = WandNextSendSeconds;
+		}
+	}
+
+	const uint32 WaitMilliseconds = NextSendSeconds > 0.0
+		? FMath::Clamp<uint32>(FMath::CeilToInt((NextSendSeconds - NowSeconds) * 1000.0), 1, IdleWaitMilliseconds)
+		: IdleWaitMilliseconds;
+
+	// Requests wake the sender up through the queue, not the worker's wake event
+	Queue.Wait(WaitMilliseconds);
+	return 0;
+}
+
+FTiltFiveHapticsSender::FWandState& FTiltFiveHapticsSender::FindOrAddWand(FT5WandHandle Wand)
+{
+	FWandState* Unused = nullptr;
+	FWandState* LeastRecentlySent = &WandStates[0];
+	for (FWandState& WandState : WandStates)
+	{
+		if (WandState.bInUse && WandState.Wand == Wand)
+		{
+			return WandState;
+		}
+		if (!WandState.bInUse && !Unused)
+		{
+			Unused = &WandState;
+		}
+		if (WandState.LastSentSeconds < LeastRecentlySent->LastSentSeconds)
+		{
+			LeastRecentlySent = &WandState;
+		}
+	}
+
+	// Wand handles change when wands reconnect, so the wand we heard of the longest time ago is most likely gone
+	FWandState& WandState = Unused ? *Unused : *LeastRecentlySent;
+	WandState = FWandState();
+	WandState.Wand = Wand;
+	WandState.bInUse = true;
+	return WandState;
+}
+
+double FTiltFiveHapticsSender::SendPending(FWandState& WandState, double NowSeconds)
+{
+	if (!WandState.bHasPending)
+	{
+		return 0.0;
+	}
+
+	const FTiltFiveHapticImpulse& Pending = WandState.Pending;
+
+	// Nothing left to play, the rate limit held it back for too long
+	if (Pending.EndSeconds <= NowSeconds)
+	{
+		WandState.bHasPending = false;
+		INC_DWORD_STAT(STAT_TiltFiveHapticsDropped);
+		return 0.0;
+	}
+
+	// Already covered well enough by what the wand is playing
+	if (WandState.ActiveEndSeconds > NowSeconds && Pending.Amplitude <= WandState.ActiveAmplitude &&
+		Pending.EndSeconds <= WandState.ActiveEndSeconds + MergeSlackSeconds)
+	{
+		WandState.bHasPending = false;
+		INC_DWORD_STAT(STAT_TiltFiveHapticsMerged);
+		return 0.0;
+	}
+
+	const double NextAllowedSeconds = WandState.LastSentSeconds + MinSendIntervalSeconds;
+	if (NowSeconds < NextAllowedSeconds)
+	{
+		return NextAllowedSeconds;
+	}
+
+	const uint16 DurationMilliseconds = static_cast<uint16>(FMath::Clamp<int32>(
+		FMath::CeilToInt((Pending.EndSeconds - NowSeconds) * 1000.0), 1, FTiltFiveHapticsQueue::MaxDurationMilliseconds));
+
+	FT5Result Result;
+	{
+		FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
+		Result = t5SendImpulse(Glasses, Pending.Wand, Pending.Amplitude, DurationMilliseconds);
+	}
+
+	WandState.bHasPending = false;
+	WandState.LastSentSeconds = NowSeconds;
+
+	if (Result != T5_SUCCESS)
+	{
+		UE_LOG(LogTiltFive,
+			Verbose,
+			TEXT("Failed to send haptic impulse to a wand of glasses %d: %S"),
+			DeviceId,
+			t5GetResultMessage(Result));
+		INC_DWORD_STAT(STAT_TiltFiveHapticsDropped);
+		return 0.0;
+	}
+
+	WandState.ActiveAmplitude = Pending.Amplitude;
+	WandState.ActiveEndSeconds = NowSeconds + DurationMilliseconds / 1000.0;
+	INC_DWORD_STAT(STAT_TiltFiveHapticsSent);
+	return 0.0;
+}
@@ -97,6 +97,13 @@ bool UTiltFiveLocalPlayer::GetProjectionData(FViewport* Viewport, FSceneViewProj
 	if (bNeedStereo)
 	{
 		TSharedPtr<class FTiltFiveXRBase, ESPMode::ThreadSafe> TiltFiveStereoRenderer = StaticCastSharedPtr<class FTiltFiveXRBase, class IStereoRendering, ESPMode::ThreadSafe>(GEngine->StereoRenderingDevice);
+
+		// Players without glasses have no place in the render target, so their views aren't rendered at all
+		if (!TiltFiveStereoRenderer->GetAtlasLayout().HasPlayer(FMath::Clamp(GetPlatformUserIndex(), 0, FTiltFiveXRBase::GMaxNumTiltFiveGlasses - 1)))
+		{
+			return false;
+		}
+
 		TiltFiveStereoRenderer->AdjustViewRect(StereoViewIndex, X, Y, SizeX, SizeY, GetPlatformUserIndex());
 	}
 
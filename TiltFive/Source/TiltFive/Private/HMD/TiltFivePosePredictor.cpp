@@ -0,0 +1,365 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "HMD/TiltFivePosePredictor.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "TiltFive.h"
+
+// Samples older than this (relative to the newest one) don't say much about the current motion anymore
+static constexpr uint64 HistoryWindowNanos = 50 * 1000 * 1000;
+
+// Gaps in tracking longer than this restart the filter instead of feeding it one huge step
+static constexpr uint64 FilterResetNanos = 100 * 1000 * 1000;
+
+// Alpha-beta filter gains. Alpha weights the measured pose against the filtered one, beta how quickly the velocity follows.
+static constexpr double FilterAlpha = 0.6;
+static constexpr double FilterBeta = 0.2;
+
+static FVector GetHardwarePosition(const FT5GlassesPose& Pose)
+{
+	return FVector(Pose.posGLS_GBD.x, Pose.posGLS_GBD.y, Pose.posGLS_GBD.z);
+}
+
+static FQuat GetHardwareRotation(const FT5GlassesPose& Pose)
+{
+	return FQuat(Pose.rotToGLS_GBD.x, Pose.rotToGLS_GBD.y, Pose.rotToGLS_GBD.z, Pose.rotToGLS_GBD.w);
+}
+
+static void SetHardwarePose(const FVector& Position, const FQuat& Rotation, FT5GlassesPose& OutPose)
+{
+	OutPose.posGLS_GBD.x = Position.X;
+	OutPose.posGLS_GBD.y = Position.Y;
+	OutPose.posGLS_GBD.z = Position.Z;
+	OutPose.rotToGLS_GBD.x = Rotation.X;
+	OutPose.rotToGLS_GBD.y = Rotation.Y;
+	OutPose.rotToGLS_GBD.z = Rotation.Z;
+	OutPose.rotToGLS_GBD.w = Rotation.W;
+}
+
+static FVector QuatToRotationVector(FQuat Rotation)
+{
+	Rotation.EnforceShortestArcWith(FQuat::Identity);
+	return Rotation.GetRotationAxis() * Rotation.GetAngle();
+}
+
+static FQuat RotationVectorToQuat(const FVector& RotationVector)
+{
+	const auto Angle = RotationVector.Size();
+	return Angle > KINDA_SMALL_NUMBER ? FQuat(RotationVector / Angle, Angle) : FQuat::Identity;
+}
+
+static double NanosToSeconds(int64 Nanos)
+{
+	return static_cast<double>(Nanos) * 1e-9;
+}
+
+void FTiltFivePosePredictor::Reset()
+{
+	bFilterInitialized = false;
+	FilterTimestampNanos = 0;
+	FilterPosition = FVector::ZeroVector;
+	FilterVelocity = FVector::ZeroVector;
+	FilterRotation = FQuat::Identity;
+	FilterAngularVelocity = FVector::ZeroVector;
+}
+
+bool FTiltFivePosePredictor::Predict(ETiltFivePosePredictionMode Mode,
+	const FTiltFivePoseSample* Samples,
+	int32 NumSamples,
+	double HorizonSeconds,
+	FT5GlassesPose& OutPose)
+{
+	if (NumSamples <= 0)
+	{
+		return false;
+	}
+
+	OutPose = Samples[0].Pose;
+	HorizonSeconds = FMath::Clamp(HorizonSeconds, 0.0, MaxHorizonSeconds);
+
+	switch (Mode)
+	{
+	case ETiltFivePosePredictionMode::ConstantVelocity:
+		PredictConstantVelocity(Samples, NumSamples, HorizonSeconds, OutPose);
+		break;
+	case ETiltFivePosePredictionMode::Kalman:
+		PredictFiltered(Samples, NumSamples, HorizonSeconds, OutPose);
+		break;
+	case ETiltFivePosePredictionMode::Disabled:
+	default:
+		break;
+	}
+
+	return true;
+}
+
+bool FTiltFivePosePredictor::Predict(
+	ETiltFivePosePredictionMode Mode, const FTiltFivePoseRing& PoseRing, double LatencySeconds, FT5GlassesPose& OutPose)
+{
+	FTiltFivePoseSample History[MaxHistory];
+	const int32 NumSamples = ReadHistory(PoseRing, History, MaxHistory);
+
+	if (NumSamples == 0)
+	{
+		Reset();
+		return false;
+	}
+
+	const double Staleness = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - History[0].HostCycles);
+	return Predict(Mode, History, NumSamples, Staleness + LatencySeconds, OutPose);
+}
+
+int32 FTiltFivePosePredictor::ReadHistory(const FTiltFivePoseRing& PoseRing, FTiltFivePoseSample* OutSamples, int32 MaxSamples)
+{
+	int32 NumSamples = 0;
+
+	for (int32 Age = 0; Age < MaxSamples; ++Age)
+	{
+		FTiltFivePoseSample Sample;
+		if (!PoseRing.Read(Age, Sample) || !Sample.bValid)
+		{
+			break;
+		}
+
+		// The sampler may have pushed while we were reading; samples that don't go back in time belong to a newer read
+		if (NumSamples > 0 && Sample.Pose.timestampNanos >= OutSamples[NumSamples - 1].Pose.timestampNanos)
+		{
+			break;
+		}
+
+		OutSamples[NumSamples++] = Sample;
+	}
+
+	return NumSamples;
+}
+
+void FTiltFivePosePredictor::PredictConstantVelocity(
+	const FTiltFivePoseSample* Samples, int32 NumSamples, double HorizonSeconds, FT5GlassesPose& OutPose) const
+{
+	const uint64 NewestTimestamp = Samples[0].Pose.timestampNanos;
+
+	int32 NumUsable = 1;
+	while (NumUsable < NumSamples && NewestTimestamp - Samples[NumUsable].Pose.timestampNanos <= HistoryWindowNanos)
+	{
+		++NumUsable;
+	}
+
+	if (NumUsable < 2)
+	{
+		return;
+	}
+
+	// Least squares fit of the linear velocity over the usable history, which is a lot less noisy than the last difference
+	double MeanTime = 0.0;
+	FVector MeanPosition = FVector::ZeroVector;
+	for (int32 Index = 0; Index < NumUsable; ++Index)
+	{
+		MeanTime += NanosToSeconds(static_cast<int64>(Samples[Index].Pose.timestampNanos - NewestTimestamp));
+		MeanPosition += GetHardwarePosition(Samples[Index].Pose);
+	}
+	MeanTime /= NumUsable;
+	MeanPosition /= NumUsable;
+
+	double TimeVariance = 0.0;
+	FVector Covariance = FVector::ZeroVector;
+	for (int32 Index = 0; Index < NumUsable; ++Index)
+	{
+		const double Time = NanosToSeconds(static_cast<int64>(Samples[Index].Pose.timestampNanos - NewestTimestamp)) - MeanTime;
+		TimeVariance += Time * Time;
+		Covariance += (GetHardwarePosition(Samples[Index].Pose) - MeanPosition) * Time;
+	}
+
+	if (TimeVariance <= 0.0)
+	{
+		return;
+	}
+
+	const FVector Velocity = Covariance / TimeVariance;
+
+	// Angular velocity from the rotation between the oldest usable and the newest sample
+	const FTiltFivePoseSample& Oldest = Samples[NumUsable - 1];
+	const double RotationDeltaTime = NanosToSeconds(static_cast<int64>(NewestTimestamp - Oldest.Pose.timestampNanos));
+	const FQuat NewestRotation = GetHardwareRotation(Samples[0].Pose);
+	const FVector AngularVelocity =
+		QuatToRotationVector(NewestRotation * GetHardwareRotation(Oldest.Pose).Inverse()) / RotationDeltaTime;
+
+	const FVector PredictedPosition = GetHardwarePosition(Samples[0].Pose) + Velocity * HorizonSeconds;
+	const FQuat PredictedRotation = (RotationVectorToQuat(AngularVelocity * HorizonSeconds) * NewestRotation).GetNormalized();
+	SetHardwarePose(PredictedPosition, PredictedRotation, OutPose);
+}
+
+void FTiltFivePosePredictor::PredictFiltered(
+	const FTiltFivePoseSample* Samples, int32 NumSamples, double HorizonSeconds, FT5GlassesPose& OutPose)
+{
+	const uint64 NewestTimestamp = Samples[0].Pose.timestampNanos;
+
+	if (bFilterInitialized && (NewestTimestamp < FilterTimestampNanos || NewestTimestamp - FilterTimestampNanos > FilterResetNanos))
+	{
+		Reset();
+	}
+
+	// Feed all samples the filter hasn't seen yet, oldest first
+	int32 Index = NumSamples - 1;
+	if (!bFilterInitialized)
+	{
+		const FTiltFivePoseSample& Oldest = Samples[Index--];
+		bFilterInitialized = true;
+		FilterTimestampNanos = Oldest.Pose.timestampNanos;
+		FilterPosition = GetHardwarePosition(Oldest.Pose);
+		FilterRotation = GetHardwareRotation(Oldest.Pose);
+	}
+
+	for (; Index >= 0; --Index)
+	{
+		const FT5GlassesPose& Pose = Samples[Index].Pose;
+		if (Pose.timestampNanos <= FilterTimestampNanos)
+		{
+			continue;
+		}
+
+		const double DeltaTime = NanosToSeconds(static_cast<int64>(Pose.timestampNanos - FilterTimestampNanos));
+		FilterTimestampNanos = Pose.timestampNanos;
+
+		const FVector PredictedPosition = FilterPosition + FilterVelocity * DeltaTime;
+		const FVector PositionResidual = GetHardwarePosition(Pose) - PredictedPosition;
+		FilterPosition = PredictedPosition + PositionResidual * FilterAlpha;
+		FilterVelocity += PositionResidual * (FilterBeta / DeltaTime);
+
+		const FQuat PredictedRotation = RotationVectorToQuat(FilterAngularVelocity * DeltaTime) * FilterRotation;
+		const FVector RotationResidual = QuatToRotationVector(GetHardwareRotation(Pose) * PredictedRotation.Inverse());
+		FilterRotation = (RotationVectorToQuat(RotationResidual * FilterAlpha) * PredictedRotation).GetNormalized();
+		FilterAngularVelocity += RotationResidual * (FilterBeta / DeltaTime);
+	}
+
+	const FVector PredictedPosition = FilterPosition + FilterVelocity * HorizonSeconds;
+	const FQuat PredictedRotation = (RotationVectorToQuat(FilterAngularVelocity * HorizonSeconds) * FilterRotation).GetNormalized();
+	SetHardwarePose(PredictedPosition, PredictedRotation, OutPose);
+}
+
+#if !UE_BUILD_SHIPPING
+// Replays a recorded pose trace through every prediction mode and reports how far off the predictions were from the poses that
+// were actually recorded at the predicted time. The trace is a CSV file with one pose per line in the format
+// timestampNanos,posX,posY,posZ,rotX,rotY,rotZ,rotW using the raw values from T5_GlassesPose.
+static void ReplayPoseTrace(const TArray<FString>& Args)
+{
+	if (Args.Num() < 1)
+	{
+		UE_LOG(LogTiltFive, Display, TEXT("Usage: TiltFive.ReplayPoseTrace <TraceFile.csv> [HorizonMilliseconds=20]"));
+		return;
+	}
+
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Args[0]))
+	{
+		UE_LOG(LogTiltFive, Error, TEXT("Failed to load pose trace %s"), *Args[0]);
+		return;
+	}
+
+	const double HorizonSeconds = (Args.Num() > 1 ? FCString::Atod(*Args[1]) : 20.0) / 1000.0;
+	const uint64 HorizonNanos = static_cast<uint64>(HorizonSeconds * 1e9);
+
+	TArray<FTiltFivePoseSample> Trace;
+	for (const FString& Line : Lines)
+	{
+		TArray<FString> Fields;
+		Line.ParseIntoArray(Fields, TEXT(","));
+
+		// Skips headers and empty lines
+		if (Fields.Num() < 8 || !Fields[0].IsNumeric())
+		{
+			continue;
+		}
+
+		FTiltFivePoseSample Sample{};
+		Sample.bValid = true;
+		Sample.Pose.timestampNanos = FCString::Strtoui64(*Fields[0], nullptr, 10);
+		SetHardwarePose(FVector(FCString::Atod(*Fields[1]), FCString::Atod(*Fields[2]), FCString::Atod(*Fields[3])),
+			FQuat(FCString::Atod(*Fields[4]), FCString::Atod(*Fields[5]), FCString::Atod(*Fields[6]), FCString::Atod(*Fields[7])),
+			Sample.Pose);
+
+		if (Trace.Num() == 0 || Sample.Pose.timestampNanos > Trace.Last().Pose.timestampNanos)
+		{
+			Trace.Add(Sample);
+		}
+	}
+
+	const UEnum* ModeEnum = StaticEnum<ETiltFivePosePredictionMode>();
+	for (int32 ModeIndex = 0; ModeIndex < ModeEnum->NumEnums() - 1; ++ModeIndex)
+	{
+		const ETiltFivePosePredictionMode Mode = static_cast<ETiltFivePosePredictionMode>(ModeEnum->GetValueByIndex(ModeIndex));
+
+		FTiltFivePosePredictor Predictor;
+		double SquaredPositionError = 0.0;
+		double SquaredRotationError = 0.0;
+		int32 NumPredictions = 0;
+		int32 TruthIndex = 0;
+
+		for (int32 Index = 0; Index < Trace.Num(); ++Index)
+		{
+			const uint64 TargetNanos = Trace[Index].Pose.timestampNanos + HorizonNanos;
+			while (TruthIndex + 1 < Trace.Num() && Trace[TruthIndex + 1].Pose.timestampNanos <= TargetNanos)
+			{
+				++TruthIndex;
+			}
+			if (TruthIndex + 1 >= Trace.Num())
+			{
+				break;
+			}
+
+			const FT5GlassesPose& Before = Trace[TruthIndex].Pose;
+			const FT5GlassesPose& After = Trace[TruthIndex + 1].Pose;
+			const double Alpha = static_cast<double>(TargetNanos - Before.timestampNanos) /
+								 static_cast<double>(After.timestampNanos - Before.timestampNanos);
+			const FVector TruePosition = FMath::Lerp(GetHardwarePosition(Before), GetHardwarePosition(After), Alpha);
+			const FQuat TrueRotation = FQuat::Slerp(GetHardwareRotation(Before), GetHardwareRotation(After), Alpha);
+
+			FTiltFivePoseSample History[FTiltFivePosePredictor::MaxHistory];
+			int32 NumHistory = 0;
+			for (int32 HistoryIndex = Index; HistoryIndex >= 0 && NumHistory < FTiltFivePosePredictor::MaxHistory; --HistoryIndex)
+			{
+				History[NumHistory++] = Trace[HistoryIndex];
+			}
+
+			FT5GlassesPose Predicted;
+			Predictor.Predict(Mode, History, NumHistory, HorizonSeconds, Predicted);
+
+			SquaredPositionError += FVector::DistSquared(GetHardwarePosition(Predicted), TruePosition);
+			SquaredRotationError += FMath::Square(GetHardwareRotation(Predicted).AngularDistance(TrueRotation));
+			++NumPredictions;
+		}
+
+		if (NumPredictions == 0)
+		{
+			UE_LOG(LogTiltFive, Display, TEXT("Pose trace %s is too short for a %.1fms horizon"), *Args[0], HorizonSeconds * 1000.0);
+			return;
+		}
+
+		UE_LOG(LogTiltFive,
+			Display,
+			TEXT("%s: RMS position error %.2fmm, RMS rotation error %.3fdeg over %d predictions %.1fms ahead"),
+			*ModeEnum->GetNameStringByIndex(ModeIndex),
+			FMath::Sqrt(SquaredPositionError / NumPredictions) * 1000.0,
+			FMath::RadiansToDegrees(FMath::Sqrt(SquaredRotationError / NumPredictions)),
+			NumPredictions,
+			HorizonSeconds * 1000.0);
+	}
+}
+
+static FAutoConsoleCommand ReplayPoseTraceCommand(TEXT("TiltFive.ReplayPoseTrace"),
+	TEXT("Replays a recorded glasses pose trace through all pose prediction modes and reports their prediction error."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&ReplayPoseTrace));
+#endif
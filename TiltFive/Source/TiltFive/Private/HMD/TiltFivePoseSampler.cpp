@@ -0,0 +1,72 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "HMD/TiltFivePoseSampler.h"
+
+#include "HAL/PlatformTime.h"
+#include "TiltFive.h"
+
+// The glasses track at a higher rate than we render, so sample a couple of times per rendered frame to keep the ring fresh
+// without spinning on the service.
+static constexpr uint32 PoseSamplePeriodMilliseconds = 2;
+
+FTiltFivePoseSampler::FTiltFivePoseSampler(FT5GlassesPtr InGlasses,
+	FCriticalSection& InExclusiveGroup1CriticalSection,
+	FTiltFivePoseRing& InPoseRing,
+	int32 InDeviceId)
+	: FTiltFiveGlassesWorker(InGlasses, InDeviceId, TEXT("TiltFivePoseSampler"), TPri_AboveNormal)
+	, ExclusiveGroup1CriticalSection(InExclusiveGroup1CriticalSection)
+	, PoseRing(InPoseRing)
+{
+}
+
+void FTiltFivePoseSampler::OnStopped()
+{
+	// Let readers know that there won't be any further poses for these glasses
+	FTiltFivePoseSample InvalidSample{};
+	InvalidSample.bValid = false;
+	InvalidSample.HostCycles = FPlatformTime::Cycles64();
+	PoseRing.Push(InvalidSample);
+}
+
+uint32 FTiltFivePoseSampler::Tick()
+{
+	FTiltFivePoseSample Sample{};
+
+	FT5Result Result;
+	{
+		FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
+		Result = t5GetGlassesPose(Glasses, kT5_GlassesPoseUsage_GlassesPresentation, &Sample.Pose);
+	}
+	Sample.HostCycles = FPlatformTime::Cycles64();
+	Sample.bValid = Result == T5_SUCCESS;
+
+	UE_CLOG(!Sample.bValid && Result != T5_ERROR_TRY_AGAIN,
+		LogTiltFive,
+		Verbose,
+		TEXT("Failed to get pose for glasses %d: %S"),
+		DeviceId,
+		t5GetResultMessage(Result));
+
+	// Only publish actual changes, so the ring holds as much distinct history as possible
+	if (Sample.bValid ? (bLastPushedValid && Sample.Pose.timestampNanos == LastPushedTimestampNanos) : !bLastPushedValid)
+	{
+		return PoseSamplePeriodMilliseconds;
+	}
+
+	PoseRing.Push(Sample);
+	bLastPushedValid = Sample.bValid;
+	LastPushedTimestampNanos = Sample.Pose.timestampNanos;
+	return PoseSamplePeriodMilliseconds;
+}
@@ -0,0 +1,175 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "HMD/TiltFiveWandStreamReader.h"
+
+#include "HAL/PlatformTime.h"
+#include "TiltFive.h"
+
+// How long a single read blocks on the stream. This bounds how long stopping the reader can take.
+static constexpr uint32 WandStreamReadTimeoutMilliseconds = 10;
+
+// Back off after errors, so a stream that keeps failing doesn't make us spin
+static constexpr uint32 WandStreamErrorBackoffMilliseconds = 20;
+
+FTiltFiveWandStreamReader::FTiltFiveWandStreamReader(FT5GlassesPtr InGlasses,
+	FCriticalSection& InExclusiveGroup2CriticalSection,
+	FTiltFiveWandEventQueue& InEventQueue,
+	FTiltFiveWandPoseRings& InPoseRings,
+	int32 InDeviceId)
+	: FTiltFiveGlassesWorker(InGlasses, InDeviceId, TEXT("TiltFiveWandStreamReader"), TPri_AboveNormal)
+	, ExclusiveGroup2CriticalSection(InExclusiveGroup2CriticalSection)
+	, EventQueue(InEventQueue)
+	, PoseRings(InPoseRings)
+{
+}
+
+void FTiltFiveWandStreamReader::OnStart()
+{
+	// Wand handles belong to the glasses they came from, so rings of previous glasses are up for grabs again
+	for (std::atomic<int32>& WandHandle : PoseRings.WandHandles)
+	{
+		WandHandle = INDEX_NONE;
+	}
+}
+
+void FTiltFiveWandStreamReader::OnStopped()
+{
+	// Let readers know that there won't be any further poses for these wands
+	FTiltFivePoseSample InvalidSample{};
+	InvalidSample.bValid = false;
+	InvalidSample.HostCycles = FPlatformTime::Cycles64();
+	for (FTiltFivePoseRing& Ring : PoseRings.Rings)
+	{
+		Ring.Push(InvalidSample);
+	}
+}
+
+uint32 FTiltFiveWandStreamReader::Tick()
+{
+	FTiltFiveWandStreamEvent StreamEvent{};
+
+	FT5Result Result;
+	{
+		FScopeLock ScopeLock(&ExclusiveGroup2CriticalSection);
+		Result = t5ReadWandStreamForGlasses(Glasses, &StreamEvent.Event, WandStreamReadTimeoutMilliseconds);
+	}
+	StreamEvent.HostCycles = FPlatformTime::Cycles64();
+
+	// The read itself blocks, so there is no need to wait before the next one
+	if (Result == T5_TIMEOUT)
+	{
+		return 0;
+	}
+
+	if (Result != T5_SUCCESS)
+	{
+		UE_LOG(LogTiltFive,
+			Error,
+			TEXT("Failed to retrieve wand stream event for glasses %d: %S"),
+			DeviceId,
+			t5GetResultMessage(Result));
+		return WandStreamErrorBackoffMilliseconds;
+	}
+
+	PublishPose(StreamEvent);
+
+	if (!EventQueue.Push(StreamEvent))
+	{
+		// The game thread isn't draining, e.g. during a hitch. Report once per run of dropped events.
+		UE_CLOG(NumDroppedEvents == 0, LogTiltFive, Warning, TEXT("Wand event queue of glasses %d is full, dropping events"), DeviceId);
+		++NumDroppedEvents;
+		return 0;
+	}
+
+	UE_CLOG(NumDroppedEvents > 0, LogTiltFive, Warning, TEXT("Dropped %u wand events of glasses %d"), NumDroppedEvents, DeviceId);
+	NumDroppedEvents = 0;
+	return 0;
+}
+
+void FTiltFiveWandStreamReader::PublishPose(const FTiltFiveWandStreamEvent& StreamEvent)
+{
+	const FT5WandStreamEvent& Event = StreamEvent.Event;
+	const bool bHasPose = Event.type == kT5_WandStreamEventType_Report && Event.report.poseValid;
+	if (!bHasPose && Event.type != kT5_WandStreamEventType_Disconnect)
+	{
+		return;
+	}
+
+	int32 RingIndex = PoseRings.FindRing(Event.wandId);
+	if (RingIndex == INDEX_NONE)
+	{
+		if (!bHasPose)
+		{
+			return;
+		}
+
+		// First pose of a wand we haven't seen yet, take the first unused ring
+		for (RingIndex = 0; RingIndex < FTiltFiveWandPoseRings::MaxWands; ++RingIndex)
+		{
+			if (PoseRings.WandHandles[RingIndex].load(std::memory_order_relaxed) == INDEX_NONE)
+			{
+				break;
+			}
+		}
+
+		// Without one, a disconnect must have been missed (e.g. dropped with a full queue), so take over the ring that went without a
+		// valid pose the longest
+		if (RingIndex == FTiltFiveWandPoseRings::MaxWands)
+		{
+			uint64 OldestHostCycles = MAX_uint64;
+			for (int32 Candidate = 0; Candidate < FTiltFiveWandPoseRings::MaxWands; ++Candidate)
+			{
+				FTiltFivePoseSample Latest;
+				const uint64 LatestHostCycles =
+					PoseRings.Rings[Candidate].ReadLatest(Latest) && Latest.bValid ? Latest.HostCycles : 0;
+				if (LatestHostCycles < OldestHostCycles)
+				{
+					OldestHostCycles = LatestHostCycles;
+					RingIndex = Candidate;
+				}
+			}
+			ReleaseRing(RingIndex, StreamEvent.HostCycles);
+		}
+	}
+
+	if (!bHasPose)
+	{
+		// The handle of a wand that reconnects may change, so the ring is freed for whichever wand shows up next
+		ReleaseRing(RingIndex, StreamEvent.HostCycles);
+		return;
+	}
+
+	FTiltFivePoseSample Sample{};
+	Sample.HostCycles = StreamEvent.HostCycles;
+	Sample.bValid = true;
+	Sample.Pose.timestampNanos = Event.report.timestampNanos;
+	Sample.Pose.posGLS_GBD = Event.report.posGrip_GBD;
+	Sample.Pose.rotToGLS_GBD = Event.report.rotToWND_GBD;
+	Sample.Pose.gameboardType = kT5_GameboardType_None;
+
+	// Publish the sample before the ring can be found by the wand handle
+	PoseRings.Rings[RingIndex].Push(Sample);
+	PoseRings.WandHandles[RingIndex].store(Event.wandId, std::memory_order_release);
+}
+
+void FTiltFiveWandStreamReader::ReleaseRing(int32 RingIndex, uint64 HostCycles)
+{
+	// Readers that still hold on to the ring see the end of the wand's poses before the ring can be taken over
+	FTiltFivePoseSample InvalidSample{};
+	InvalidSample.bValid = false;
+	InvalidSample.HostCycles = HostCycles;
+	PoseRings.Rings[RingIndex].Push(InvalidSample);
+	PoseRings.WandHandles[RingIndex].store(INDEX_NONE, std::memory_order_release);
+}
@@ -42,9 +42,7 @@ void FTiltFiveSceneViewExtension::SetupView(FSceneViewFamily& InViewFamily, FSce
 	}
 
 	TSharedPtr<class FTiltFiveXRBase, ESPMode::ThreadSafe> TiltFiveXRSystem = StaticCastSharedPtr<class FTiltFiveXRBase, class IXRTrackingSystem, ESPMode::ThreadSafe>(GEngine->XRSystem);
-	uint32 RTWidth = TiltFiveXRSystem->GlassesList[InView.PlayerIndex]->EyeInfos[InView.StereoViewIndex].BufferedRTRHI->GetSizeX();
-	uint32 RTHeight = TiltFiveXRSystem->GlassesList[InView.PlayerIndex]->EyeInfos[InView.StereoViewIndex].BufferedRTRHI->GetSizeY();
-	InView.UnconstrainedViewRect = FIntRect(InView.StereoViewIndex * RTWidth, InView.PlayerIndex * RTHeight, (InView.StereoViewIndex * RTWidth) + RTWidth, (InView.PlayerIndex * RTHeight) + RTHeight);
+	InView.UnconstrainedViewRect = TiltFiveXRSystem->GetAtlasLayout().GetEyeRect(InView.PlayerIndex, InView.StereoViewIndex);
 }
 
 void FTiltFiveSceneViewExtension::BeginRenderViewFamily(FSceneViewFamily& InViewFamily)
@@ -73,18 +71,29 @@ void FTiltFiveSceneViewExtension::PreRenderViewFamily_RenderThread(
 
 	for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> HMD : TiltFiveXRSystem->GlassesList) {
 		if (HMD->IsHMDEnabled()) {
+			// Re-predict the pose from the freshest samples, this is as close to the frame being sent as we get
+			HMD->UpdateCachedGlassesPose_RenderThread();
+
+			// Each player has two views in the family, find the first one of this player
+			const FSceneView* MainView = nullptr;
+			for (const FSceneView* View : InViewFamily.Views)
+			{
+				if (View && View->PlayerIndex == HMD->DeviceId)
+				{
+					MainView = View;
+					break;
+				}
+			}
+
 			FQuat CurrentOrientation;
 			FVector CurrentPosition;
-			if (TrackingSystem->DoesSupportLateUpdate() && TrackingSystem->GetCurrentPose(HMD->DeviceId, CurrentOrientation, CurrentPosition))
+			if (MainView && TrackingSystem->DoesSupportLateUpdate() && TrackingSystem->GetCurrentPose(HMD->DeviceId, CurrentOrientation, CurrentPosition))
 			{
-				const FSceneView* MainView = InViewFamily.Views[HMD->DeviceId];
-				check(MainView);
-
 				const FTransform OldRelativeTransform(MainView->BaseHmdOrientation, MainView->BaseHmdLocation);
 				const FTransform CurrentRelativeTransform(CurrentOrientation, CurrentPosition);
 
 				LateUpdate.Apply_RenderThread(InViewFamily.Scene, OldRelativeTransform, CurrentRelativeTransform);
-				TrackingSystem->OnLateUpdateApplied_RenderThread(GraphBuilder.RHICmdList, CurrentRelativeTransform);
+				TiltFiveXRSystem->OnLateUpdateApplied_RenderThread(GraphBuilder.RHICmdList, CurrentRelativeTransform, HMD->DeviceId);
 			}
 		}
 	}
@@ -0,0 +1,182 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "Misc/AutomationTest.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+#include "HMD/TiltFiveHMD.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/** Forwards to the engine allocator and counts the allocations made by the thread that created it. */
+	class FTiltFiveCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FTiltFiveCountingMalloc(FMalloc* InInnerMalloc)
+			: InnerMalloc(InInnerMalloc)
+			, CountedThreadId(FPlatformTLS::GetCurrentThreadId())
+		{
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			InnerMalloc->Free(Original);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return InnerMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return InnerMalloc->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return InnerMalloc->IsInternallyThreadSafe();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return TEXT("TiltFiveCountingMalloc");
+		}
+
+		int32 GetNumAllocations() const
+		{
+			return NumAllocations.load();
+		}
+
+	private:
+		void CountAllocation()
+		{
+			if (FPlatformTLS::GetCurrentThreadId() == CountedThreadId)
+			{
+				++NumAllocations;
+			}
+		}
+
+		FMalloc* InnerMalloc;
+		uint32 CountedThreadId;
+		std::atomic<int32> NumAllocations{0};
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiltFiveFrameStateTest,
+	"TiltFive.FrameState",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiltFiveFrameStateTest::RunTest(const FString& Parameters)
+{
+	static constexpr int32 NumFrames = 256;
+	static constexpr int32 NumSlots = FTiltFiveGlassesRegistry::NumSlots;
+
+	// The render thread reads the state of two frames ago, the state of the last frame is still on its way to it
+	static constexpr int32 RenderThreadLag = FTiltFiveFrameStateRing::NumFrameStates - 1;
+
+	FTiltFiveFrameStateRing FrameStates;
+	const FTiltFiveFrameState* FilledStates[NumFrames] = {};
+
+	// Nothing below may allocate on this thread, so failures are only counted here and reported once the allocator is restored
+	int32 NumStatesInUse = 0;
+	int32 NumWrongFrames = 0;
+	int32 NumChangedStates = 0;
+	int32 NumStaleGlasses = 0;
+
+	FMalloc* const EngineMalloc = GMalloc;
+	FTiltFiveCountingMalloc CountingMalloc(EngineMalloc);
+	GMalloc = &CountingMalloc;
+
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		FTiltFiveFrameState& FrameState = FrameStates.BeginFrame_GameThread(Frame);
+		for (int32 InFlight = 1; InFlight <= RenderThreadLag && Frame - InFlight >= 0; ++InFlight)
+		{
+			NumStatesInUse += FilledStates[Frame - InFlight] == &FrameState ? 1 : 0;
+		}
+
+		// Glasses come and go every frame, the ones that went away must not keep the pose of an earlier frame
+		const uint32 EnabledPlayerMask = (Frame * 7) % (1u << NumSlots);
+		for (int32 PlayerIndex = 0; PlayerIndex < NumSlots; ++PlayerIndex)
+		{
+			FTiltFiveFrameGlassesState& GlassesState = FrameState.Glasses[PlayerIndex];
+			NumStaleGlasses += GlassesState.bEnabled || GlassesState.MaybeRelativeGlassesTransform.IsSet() ? 1 : 0;
+
+			GlassesState.bEnabled = (EnabledPlayerMask & (1u << PlayerIndex)) != 0;
+			if (!GlassesState.bEnabled)
+			{
+				continue;
+			}
+
+			GlassesState.MaybeRelativeGlassesTransform = FTransform(FVector(Frame, PlayerIndex, 0.0f));
+			GlassesState.PoseTime = Frame;
+			GlassesState.IPD = 0.06f + PlayerIndex * 0.001f;
+			GlassesState.FOV = 70.0f;
+		}
+
+		FrameState.DefaultViewPlayerIndex = FTiltFiveAtlasLayout::FindDefaultViewPlayer(EnabledPlayerMask);
+		FrameState.Atlas.Build(FIntPoint(DefaultEyeSizeX, DefaultEyeSizeY), EnabledPlayerMask, FrameState.DefaultViewPlayerIndex);
+		FilledStates[Frame] = &FrameState;
+
+		// What the render thread reads is still what the game thread filled in back then
+		if (Frame >= RenderThreadLag)
+		{
+			const int32 RenderFrame = Frame - RenderThreadLag;
+			const FTiltFiveFrameState& RenderState = *FilledStates[RenderFrame];
+			NumWrongFrames += RenderState.FrameNumber != static_cast<uint64>(RenderFrame) ? 1 : 0;
+
+			const uint32 RenderPlayerMask = (RenderFrame * 7) % (1u << NumSlots);
+			for (int32 PlayerIndex = 0; PlayerIndex < NumSlots; ++PlayerIndex)
+			{
+				const FTiltFiveFrameGlassesState& GlassesState = RenderState.Glasses[PlayerIndex];
+				const bool bExpectEnabled = (RenderPlayerMask & (1u << PlayerIndex)) != 0;
+				const bool bChanged = GlassesState.bEnabled != bExpectEnabled ||
+					(bExpectEnabled &&
+						(GlassesState.PoseTime != RenderFrame || !GlassesState.MaybeRelativeGlassesTransform.IsSet() ||
+							GlassesState.MaybeRelativeGlassesTransform->GetLocation().X != RenderFrame));
+				NumChangedStates += bChanged ? 1 : 0;
+			}
+		}
+	}
+
+	GMalloc = EngineMalloc;
+
+	TestEqual(TEXT("Heap allocations while filling and swapping frame states"), CountingMalloc.GetNumAllocations(), 0);
+	TestEqual(TEXT("Frame states handed out while still in flight"), NumStatesInUse, 0);
+	TestEqual(TEXT("Frame states read for the wrong frame"), NumWrongFrames, 0);
+	TestEqual(TEXT("Frame states changed while in flight"), NumChangedStates, 0);
+	TestEqual(TEXT("Glasses handed out with the state of an earlier frame"), NumStaleGlasses, 0);
+
+	return true;
+}
+
+#endif
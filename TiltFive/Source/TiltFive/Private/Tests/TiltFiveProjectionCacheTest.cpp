@@ -0,0 +1,100 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "Misc/AutomationTest.h"
+#include "HMD/TiltFiveHMD.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiltFiveProjectionCacheTest,
+	"TiltFive.ProjectionCache",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiltFiveProjectionCacheTest::RunTest(const FString& Parameters)
+{
+	struct FFrame
+	{
+		float FOV;
+		FIntPoint EyeSize;
+		float NearPlane;
+		bool bExpectUpdate;
+	};
+
+	// Several frames with the same inputs between every change, and changes that go back to earlier inputs
+	const FFrame Frames[] = {
+		{70.0f, FIntPoint(1216, 768), 10.0f, true},
+		{70.0f, FIntPoint(1216, 768), 10.0f, false},
+		{70.0f, FIntPoint(1216, 768), 10.0f, false},
+		{55.0f, FIntPoint(1216, 768), 10.0f, true},
+		{55.0f, FIntPoint(1216, 768), 10.0f, false},
+		{55.0f, FIntPoint(1440, 900), 10.0f, true},
+		{55.0f, FIntPoint(1440, 900), 10.0f, false},
+		{55.0f, FIntPoint(1440, 900), 5.0f, true},
+		{55.0f, FIntPoint(1440, 900), 5.0f, false},
+		{70.0f, FIntPoint(1216, 768), 10.0f, true},
+		{70.0f, FIntPoint(1216, 768), 10.0f, false},
+	};
+
+	// GetProjectionData asks the game thread cache once per eye view and the mono view, Present the render thread cache once
+	static constexpr int32 NumGameThreadQueries = 3;
+
+	FTiltFiveProjectionCache GameThreadCache;
+	FTiltFiveProjectionCache RenderThreadCache;
+	FTiltFiveProjection PreviousProjection;
+
+	for (int32 FrameIndex = 0; FrameIndex < UE_ARRAY_COUNT(Frames); ++FrameIndex)
+	{
+		const FFrame& Frame = Frames[FrameIndex];
+		const FString Context = FString::Printf(TEXT("frame %d"), FrameIndex);
+
+		const uint32 GameThreadUpdates = GameThreadCache.GetNumUpdates();
+		const uint32 RenderThreadUpdates = RenderThreadCache.GetNumUpdates();
+
+		FTiltFiveProjection GameThreadProjection;
+		for (int32 Query = 0; Query < NumGameThreadQueries; ++Query)
+		{
+			GameThreadProjection = GameThreadCache.Get(Frame.FOV, Frame.EyeSize, Frame.NearPlane);
+		}
+		const FTiltFiveProjection RenderThreadProjection = RenderThreadCache.Get(Frame.FOV, Frame.EyeSize, Frame.NearPlane);
+
+		const int32 ExpectedUpdates = Frame.bExpectUpdate ? 1 : 0;
+		TestEqual(Context + TEXT(": game thread recomputations"),
+			static_cast<int32>(GameThreadCache.GetNumUpdates() - GameThreadUpdates),
+			ExpectedUpdates);
+		TestEqual(Context + TEXT(": render thread recomputations"),
+			static_cast<int32>(RenderThreadCache.GetNumUpdates() - RenderThreadUpdates),
+			ExpectedUpdates);
+
+		// The game thread renders with exactly the projection the render thread sends to the glasses
+		TestTrue(Context + TEXT(": projection matrices match"),
+			FMemory::Memcmp(&GameThreadProjection.ProjectionMatrix, &RenderThreadProjection.ProjectionMatrix, sizeof(FMatrix)) == 0);
+		TestEqual(Context + TEXT(": StartX_VCI"), GameThreadProjection.StartX_VCI, RenderThreadProjection.StartX_VCI);
+		TestEqual(Context + TEXT(": StartY_VCI"), GameThreadProjection.StartY_VCI, RenderThreadProjection.StartY_VCI);
+		TestEqual(Context + TEXT(": Width_VCI"), GameThreadProjection.Width_VCI, RenderThreadProjection.Width_VCI);
+		TestEqual(Context + TEXT(": Height_VCI"), GameThreadProjection.Height_VCI, RenderThreadProjection.Height_VCI);
+
+		// Every recomputation was for inputs that change the projection
+		if (Frame.bExpectUpdate && FrameIndex > 0)
+		{
+			TestFalse(Context + TEXT(": projection changed with its inputs"),
+				FMemory::Memcmp(&GameThreadProjection.ProjectionMatrix, &PreviousProjection.ProjectionMatrix, sizeof(FMatrix)) == 0);
+		}
+		PreviousProjection = GameThreadProjection;
+	}
+
+	return true;
+}
+
+#endif
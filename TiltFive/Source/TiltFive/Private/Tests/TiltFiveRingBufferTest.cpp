@@ -0,0 +1,253 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "Misc/AutomationTest.h"
+#include "Async/Async.h"
+#include "Math/RandomStream.h"
+#include "TiltFiveRingBuffer.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/** A sample large enough to be torn, whose words can all be derived from its index. */
+	struct FTiltFiveTestSample
+	{
+		uint64 Index = 0;
+		uint64 Words[7] = {};
+
+		static FTiltFiveTestSample Make(uint64 Index)
+		{
+			FTiltFiveTestSample Sample;
+			Sample.Index = Index;
+			for (int32 WordIndex = 0; WordIndex < UE_ARRAY_COUNT(Sample.Words); ++WordIndex)
+			{
+				Sample.Words[WordIndex] = Index * (WordIndex + 3) ^ 0x5bd1e995ull;
+			}
+			return Sample;
+		}
+
+		bool IsIntact() const
+		{
+			for (int32 WordIndex = 0; WordIndex < UE_ARRAY_COUNT(Words); ++WordIndex)
+			{
+				if (Words[WordIndex] != (Index * (WordIndex + 3) ^ 0x5bd1e995ull))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	static constexpr uint64 NumStressSamples = 200000;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiltFiveSeqlockRingTest,
+	"TiltFive.RingBuffer.SeqlockRing",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiltFiveSeqlockRingTest::RunTest(const FString& Parameters)
+{
+	static constexpr uint32 Capacity = 8;
+
+	{
+		TTiltFiveSeqlockRing<FTiltFiveTestSample, Capacity> Ring;
+		FTiltFiveTestSample Sample;
+		TestFalse(TEXT("Nothing to read before the first push"), Ring.ReadLatest(Sample));
+
+		// Age counts back from the latest push
+		for (uint64 Index = 0; Index < 5; ++Index)
+		{
+			Ring.Push(FTiltFiveTestSample::Make(Index));
+		}
+		for (uint32 Age = 0; Age < 5; ++Age)
+		{
+			TestTrue(FString::Printf(TEXT("Age %u is readable"), Age), Ring.Read(Age, Sample) && Sample.IsIntact());
+			TestEqual(FString::Printf(TEXT("Age %u"), Age), static_cast<int64>(Sample.Index), static_cast<int64>(4 - Age));
+		}
+		TestFalse(TEXT("Nothing older than the first push"), Ring.Read(5, Sample));
+
+		// Once the ring wrapped, the newest Capacity - 1 elements stay readable and older ones are gone
+		for (uint64 Index = 5; Index < 100; ++Index)
+		{
+			Ring.Push(FTiltFiveTestSample::Make(Index));
+		}
+		TestEqual(TEXT("Pushes counted across wrap-around"), static_cast<int64>(Ring.GetNumPushed()), static_cast<int64>(100));
+		for (uint32 Age = 0; Age < Capacity - 1; ++Age)
+		{
+			TestTrue(FString::Printf(TEXT("Age %u is readable after wrapping"), Age), Ring.Read(Age, Sample) && Sample.IsIntact());
+			TestEqual(FString::Printf(TEXT("Age %u after wrapping"), Age),
+				static_cast<int64>(Sample.Index),
+				static_cast<int64>(99 - Age));
+		}
+		TestFalse(TEXT("The slot the producer writes next is never read"), Ring.Read(Capacity - 1, Sample));
+		TestFalse(TEXT("Lapped elements are gone"), Ring.Read(Capacity, Sample));
+	}
+
+	// One producer pushing as fast as it can, one consumer reading the latest and older elements
+	{
+		TTiltFiveSeqlockRing<FTiltFiveTestSample, Capacity> Ring;
+		std::atomic<bool> bProducerDone{false};
+
+		TFuture<void> Producer = Async(EAsyncExecution::Thread,
+			[&Ring, &bProducerDone]()
+			{
+				for (uint64 Index = 0; Index < NumStressSamples; ++Index)
+				{
+					Ring.Push(FTiltFiveTestSample::Make(Index));
+				}
+				bProducerDone = true;
+			});
+
+		FRandomStream Random(7);
+		int32 NumReads = 0;
+		int32 NumTorn = 0;
+		int32 NumOutOfOrder = 0;
+		int32 NumWrongAge = 0;
+		uint64 LatestIndex = 0;
+		bool bFinalPass = false;
+		while (!bFinalPass)
+		{
+			bFinalPass = bProducerDone;
+
+			const uint32 Age = Random.RandRange(0, Capacity - 2);
+			const uint64 PushedBefore = Ring.GetNumPushed();
+			FTiltFiveTestSample Sample;
+			const bool bRead = Ring.Read(Age, Sample);
+			const uint64 PushedAfter = Ring.GetNumPushed();
+			if (!bRead)
+			{
+				continue;
+			}
+			++NumReads;
+
+			NumTorn += Sample.IsIntact() ? 0 : 1;
+
+			// The element was Age pushes older than the latest one at some point during the read
+			NumWrongAge += Sample.Index + Age + 1 < PushedBefore || Sample.Index + Age + 1 > PushedAfter ? 1 : 0;
+
+			if (Age == 0)
+			{
+				NumOutOfOrder += Sample.Index < LatestIndex ? 1 : 0;
+				LatestIndex = Sample.Index;
+			}
+		}
+		Producer.Wait();
+
+		TestTrue(TEXT("The consumer read while the producer was pushing"), NumReads > 0);
+		TestEqual(TEXT("Torn reads"), NumTorn, 0);
+		TestEqual(TEXT("Latest elements going back in time"), NumOutOfOrder, 0);
+		TestEqual(TEXT("Elements read at the wrong age"), NumWrongAge, 0);
+
+		FTiltFiveTestSample Sample;
+		TestTrue(TEXT("Latest element readable after the producer stopped"), Ring.ReadLatest(Sample));
+		TestEqual(TEXT("Latest element after the producer stopped"),
+			static_cast<int64>(Sample.Index),
+			static_cast<int64>(NumStressSamples - 1));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiltFiveSpscQueueTest,
+	"TiltFive.RingBuffer.SpscQueue",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiltFiveSpscQueueTest::RunTest(const FString& Parameters)
+{
+	static constexpr uint32 Capacity = 8;
+
+	{
+		TTiltFiveSpscQueue<FTiltFiveTestSample, Capacity> Queue;
+		FTiltFiveTestSample Sample;
+		TestFalse(TEXT("Nothing to pop before the first push"), Queue.Pop(Sample));
+
+		// A full queue refuses pushes without losing what it holds
+		for (uint64 Index = 0; Index < Capacity; ++Index)
+		{
+			TestTrue(FString::Printf(TEXT("Push %llu fits"), Index), Queue.Push(FTiltFiveTestSample::Make(Index)));
+		}
+		TestFalse(TEXT("Push into a full queue"), Queue.Push(FTiltFiveTestSample::Make(Capacity)));
+
+		// Popping one makes room for one more, which wraps around
+		TestTrue(TEXT("Pop from a full queue"), Queue.Pop(Sample));
+		TestEqual(TEXT("Oldest element first"), static_cast<int64>(Sample.Index), static_cast<int64>(0));
+		TestTrue(TEXT("Push after making room"), Queue.Push(FTiltFiveTestSample::Make(Capacity)));
+		TestFalse(TEXT("Push into the full queue again"), Queue.Push(FTiltFiveTestSample::Make(Capacity + 1)));
+
+		for (uint64 Index = 1; Index <= Capacity; ++Index)
+		{
+			TestTrue(FString::Printf(TEXT("Pop %llu"), Index), Queue.Pop(Sample) && Sample.IsIntact());
+			TestEqual(FString::Printf(TEXT("Pop %llu in order"), Index), static_cast<int64>(Sample.Index), static_cast<int64>(Index));
+		}
+		TestFalse(TEXT("Pop from the drained queue"), Queue.Pop(Sample));
+
+		// Keep going round, one element at a time
+		for (uint64 Index = 0; Index < Capacity * 3; ++Index)
+		{
+			Queue.Push(FTiltFiveTestSample::Make(Index));
+			TestTrue(TEXT("Pop after wrap-around"), Queue.Pop(Sample) && Sample.Index == Index);
+			TestFalse(TEXT("Empty after every pop"), Queue.Pop(Sample));
+		}
+	}
+
+	// One producer retrying whenever the queue is full, one consumer popping as fast as it can
+	{
+		TTiltFiveSpscQueue<FTiltFiveTestSample, Capacity> Queue;
+
+		TFuture<void> Producer = Async(EAsyncExecution::Thread,
+			[&Queue]()
+			{
+				for (uint64 Index = 0; Index < NumStressSamples; ++Index)
+				{
+					while (!Queue.Push(FTiltFiveTestSample::Make(Index)))
+					{
+						FPlatformProcess::Yield();
+					}
+				}
+			});
+
+		int32 NumTorn = 0;
+		int32 NumOutOfOrder = 0;
+		uint64 NextIndex = 0;
+		while (NextIndex < NumStressSamples)
+		{
+			FTiltFiveTestSample Sample;
+			if (!Queue.Pop(Sample))
+			{
+				FPlatformProcess::Yield();
+				continue;
+			}
+
+			NumTorn += Sample.IsIntact() ? 0 : 1;
+			NumOutOfOrder += Sample.Index != NextIndex ? 1 : 0;
+			NextIndex = Sample.Index + 1;
+		}
+		Producer.Wait();
+
+		TestEqual(TEXT("Torn elements"), NumTorn, 0);
+		TestEqual(TEXT("Elements lost, repeated or reordered"), NumOutOfOrder, 0);
+
+		FTiltFiveTestSample Sample;
+		TestFalse(TEXT("Queue drained once every element was popped"), Queue.Pop(Sample));
+	}
+
+	return true;
+}
+
+#endif
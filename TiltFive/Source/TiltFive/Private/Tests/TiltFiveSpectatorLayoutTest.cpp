@@ -0,0 +1,94 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "Misc/AutomationTest.h"
+#include "TiltFiveSpectatorController.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiltFiveSpectatorLayoutTest,
+	"TiltFive.SpectatorLayout",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiltFiveSpectatorLayoutTest::RunTest(const FString& Parameters)
+{
+	// Landscape and portrait windows, and one that doesn't start at the origin
+	const FIntRect TargetRects[] = {FIntRect(0, 0, 1920, 1080), FIntRect(0, 0, 800, 1280), FIntRect(100, 50, 900, 650)};
+	const ETiltFiveSpectatorLayoutMode Modes[] = {ETiltFiveSpectatorLayoutMode::Grid, ETiltFiveSpectatorLayoutMode::PictureInPicture};
+	const int32 Paddings[] = {0, 4, 16};
+
+	TArray<FIntRect> TileRects;
+	for (const FIntRect& TargetRect : TargetRects)
+	{
+		for (ETiltFiveSpectatorLayoutMode Mode : Modes)
+		{
+			const bool bPictureInPicture = Mode == ETiltFiveSpectatorLayoutMode::PictureInPicture;
+
+			// Grids with every column count, insets from the smallest to the largest scale
+			const int32 NumVariants = bPictureInPicture ? 3 : FTiltFiveGlassesRegistry::NumSlots + 1;
+			for (int32 Variant = 0; Variant < NumVariants; ++Variant)
+			{
+				for (int32 Padding : Paddings)
+				{
+					FTiltFiveSpectatorLayout Layout;
+					Layout.Mode = Mode;
+					Layout.GridColumns = bPictureInPicture ? 0 : Variant;
+					Layout.InsetScale = bPictureInPicture ? 0.05f + Variant * 0.225f : 0.25f;
+					Layout.Padding = Padding;
+
+					for (int32 NumTiles = 1; NumTiles <= FTiltFiveGlassesRegistry::NumSlots; ++NumTiles)
+					{
+						const FString Context = FString::Printf(TEXT("%s %d (variant %d, padding %d) in %s"),
+							bPictureInPicture ? TEXT("picture in picture") : TEXT("grid"),
+							NumTiles,
+							Variant,
+							Padding,
+							*TargetRect.ToString());
+
+						TiltFiveSpectatorController::GetLayoutTileRects(Layout, NumTiles, TargetRect, TileRects);
+						if (!TestEqual(Context + TEXT(": tiles"), TileRects.Num(), NumTiles))
+						{
+							continue;
+						}
+
+						if (bPictureInPicture)
+						{
+							TestTrue(Context + TEXT(": first player fills the window"), TileRects[0] == TargetRect);
+						}
+
+						for (int32 TileIndex = 0; TileIndex < NumTiles; ++TileIndex)
+						{
+							const FIntRect& TileRect = TileRects[TileIndex];
+							TestTrue(Context + TEXT(": tile not empty"), TileRect.Width() > 0 && TileRect.Height() > 0);
+							TestTrue(Context + TEXT(": tile inside the window"),
+								TileRect.Min.X >= TargetRect.Min.X && TileRect.Min.Y >= TargetRect.Min.Y &&
+									TileRect.Max.X <= TargetRect.Max.X && TileRect.Max.Y <= TargetRect.Max.Y);
+
+							// Insets are drawn over the first player, but never over each other
+							for (int32 OtherIndex = bPictureInPicture ? 1 : 0; OtherIndex < TileIndex; ++OtherIndex)
+							{
+								TestFalse(Context + TEXT(": tiles overlap"), TileRect.Intersect(TileRects[OtherIndex]));
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
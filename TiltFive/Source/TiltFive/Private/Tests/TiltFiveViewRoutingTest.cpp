@@ -0,0 +1,120 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "TiltFiveXRBase.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiltFiveViewRoutingTest,
+	"TiltFive.ViewRouting",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiltFiveViewRoutingTest::RunTest(const FString& Parameters)
+{
+	struct FQuery
+	{
+		int32 ViewIndex;
+		int32 PlayerIndex;
+		FTiltFiveViewRoute Expected;
+		bool bExpectedEyeView;
+	};
+
+	const int32 NumSlots = FTiltFiveGlassesRegistry::NumSlots;
+	const int32 ViewIndices[] = {EStereoscopicEye::eSSE_MONOSCOPIC, EStereoscopicEye::eSSE_LEFT_EYE, EStereoscopicEye::eSSE_RIGHT_EYE};
+	FRandomStream Random(5);
+
+	// Every combination of connected players, from none up to all of them
+	for (uint32 EnabledPlayerMask = 0; EnabledPlayerMask < (1u << NumSlots); ++EnabledPlayerMask)
+	{
+		const int32 NumPlayers = FMath::CountBits(EnabledPlayerMask);
+		const int32 DefaultViewPlayerIndex = FTiltFiveAtlasLayout::FindDefaultViewPlayer(EnabledPlayerMask);
+		const FString Context = FString::Printf(TEXT("players 0x%x"), EnabledPlayerMask);
+
+		TestTrue(Context + TEXT(": default view player has glasses"),
+			NumPlayers == 0 ? DefaultViewPlayerIndex == 0 : (EnabledPlayerMask & (1u << DefaultViewPlayerIndex)) != 0);
+
+		FTiltFiveAtlasLayout Atlas;
+		Atlas.Build(FIntPoint(1216, 768), EnabledPlayerMask, DefaultViewPlayerIndex);
+		TestEqual(Context + TEXT(": atlas rows"), Atlas.NumRows, FMath::Max(NumPlayers, 1));
+
+		// Every view of every player, and the views that don't name a player
+		TArray<FQuery> Queries;
+		for (int32 PlayerIndex = INDEX_NONE; PlayerIndex < NumSlots; ++PlayerIndex)
+		{
+			for (int32 ViewIndex : ViewIndices)
+			{
+				FQuery& Query = Queries.AddDefaulted_GetRef();
+				Query.ViewIndex = ViewIndex;
+				Query.PlayerIndex = PlayerIndex;
+				Query.Expected.PlayerIndex = PlayerIndex == INDEX_NONE ? DefaultViewPlayerIndex : PlayerIndex;
+				Query.Expected.EyeIndex = ViewIndex == EStereoscopicEye::eSSE_RIGHT_EYE ? 1 : 0;
+				Query.bExpectedEyeView = ViewIndex != EStereoscopicEye::eSSE_MONOSCOPIC;
+			}
+		}
+
+		// Routing must not depend on what was routed before, so the same queries are asked in several orders
+		for (int32 Order = 0; Order < 4; ++Order)
+		{
+			for (int32 Index = Queries.Num() - 1; Index > 0; --Index)
+			{
+				Queries.Swap(Index, Random.RandRange(0, Index));
+			}
+
+			for (const FQuery& Query : Queries)
+			{
+				FTiltFiveViewRoute Route;
+				const bool bEyeView = FTiltFiveViewRoute::Route(Query.ViewIndex, Query.PlayerIndex, DefaultViewPlayerIndex, Route);
+				const FString QueryContext =
+					FString::Printf(TEXT("%s, view %d of player %d"), *Context, Query.ViewIndex, Query.PlayerIndex);
+
+				TestEqual(QueryContext + TEXT(": eye view"), bEyeView, Query.bExpectedEyeView);
+				TestEqual(QueryContext + TEXT(": player"), Route.PlayerIndex, Query.Expected.PlayerIndex);
+				TestEqual(QueryContext + TEXT(": eye"), Route.EyeIndex, Query.Expected.EyeIndex);
+			}
+		}
+
+		// The eyes of all rendered players lie within the render target and don't overlap
+		TArray<FIntRect> EyeRects;
+		for (int32 PlayerIndex = 0; PlayerIndex < NumSlots; ++PlayerIndex)
+		{
+			if (!Atlas.HasPlayer(PlayerIndex))
+			{
+				continue;
+			}
+
+			TestTrue(Context + TEXT(": rendered players have glasses or are the default"),
+				(EnabledPlayerMask & (1u << PlayerIndex)) != 0 || (NumPlayers == 0 && PlayerIndex == DefaultViewPlayerIndex));
+
+			for (int32 EyeIndex = 0; EyeIndex < NumEyeRenderTargets; ++EyeIndex)
+			{
+				const FIntRect EyeRect = Atlas.GetEyeRect(PlayerIndex, EyeIndex);
+				TestTrue(Context + TEXT(": eye inside the render target"),
+					EyeRect.Min.X >= 0 && EyeRect.Min.Y >= 0 && EyeRect.Max.X <= Atlas.GetSize().X &&
+						EyeRect.Max.Y <= Atlas.GetSize().Y);
+
+				for (const FIntRect& OtherEyeRect : EyeRects)
+				{
+					TestFalse(Context + TEXT(": eyes overlap"), EyeRect.Intersect(OtherEyeRect));
+				}
+				EyeRects.Add(EyeRect);
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
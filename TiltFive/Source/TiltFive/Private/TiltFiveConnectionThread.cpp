@@ -0,0 +1,107 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "TiltFiveConnectionThread.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "HMD/TiltFiveHMD.h"
+#include "TiltFiveGlassesRegistry.h"
+#include "TiltFiveParamWatcher.h"
+
+// Every state machine advances by at most one step per tick, so this is also the time between two attempts at waking up glasses
+static constexpr uint32 ConnectionTickPeriodMilliseconds = 100;
+
+FTiltFiveConnectionThread::FTiltFiveConnectionThread(FTiltFiveGlassesRegistry& InGlassesRegistry,
+	FTiltFiveParamWatcher& InParamWatcher,
+	const TArray<TSharedPtr<FTiltFiveHMD, ESPMode::ThreadSafe>>& InGlassesList)
+	: GlassesRegistry(InGlassesRegistry)
+	, ParamWatcher(InParamWatcher)
+	, GlassesList(InGlassesList)
+{
+}
+
+FTiltFiveConnectionThread::~FTiltFiveConnectionThread()
+{
+	StopAndWait();
+}
+
+bool FTiltFiveConnectionThread::Start()
+{
+	check(!Thread);
+
+	bStopRequested = false;
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("TiltFiveConnection"), 0, TPri_BelowNormal);
+
+	if (!Thread)
+	{
+		UE_LOG(LogTiltFive, Error, TEXT("Failed to create glasses connection thread"));
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+void FTiltFiveConnectionThread::StopAndWait()
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	// Kill() calls Stop() before waiting for the thread to exit
+	Thread->Kill(true);
+	delete Thread;
+	Thread = nullptr;
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+void FTiltFiveConnectionThread::AllowNewConnections()
+{
+	bAllowNewConnections = true;
+}
+
+uint32 FTiltFiveConnectionThread::Run()
+{
+	while (!bStopRequested)
+	{
+		// One listing of the glasses for all state machines
+		GlassesRegistry.Refresh_ConnectionThread();
+		ParamWatcher.UpdateSystemParams_ConnectionThread();
+
+		for (const TSharedPtr<FTiltFiveHMD, ESPMode::ThreadSafe>& HMD : GlassesList)
+		{
+			HMD->TickConnection_ConnectionThread(bAllowNewConnections);
+		}
+
+		WakeEvent->Wait(ConnectionTickPeriodMilliseconds);
+	}
+
+	return 0;
+}
+
+void FTiltFiveConnectionThread::Stop()
+{
+	bStopRequested = true;
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
@@ -0,0 +1,60 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+
+#include <atomic>
+
+class FEvent;
+class FRunnableThread;
+class FTiltFiveGlassesRegistry;
+class FTiltFiveHMD;
+class FTiltFiveParamWatcher;
+
+/**
+ * Drives the connection state machines of all glasses in the background, so connecting, waking up and losing glasses never
+ * stalls the game or render thread.
+ */
+class FTiltFiveConnectionThread : public FRunnable
+{
+public:
+	FTiltFiveConnectionThread(FTiltFiveGlassesRegistry& InGlassesRegistry,
+		FTiltFiveParamWatcher& InParamWatcher,
+		const TArray<TSharedPtr<FTiltFiveHMD, ESPMode::ThreadSafe>>& InGlassesList);
+	virtual ~FTiltFiveConnectionThread() override;
+
+	bool Start();
+	void StopAndWait();
+
+	/** Lets the state machines pick up new glasses. Until then only the connections of glasses we already have are maintained. */
+	void AllowNewConnections();
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	// /FRunnable
+
+private:
+	FTiltFiveGlassesRegistry& GlassesRegistry;
+	FTiltFiveParamWatcher& ParamWatcher;
+	TArray<TSharedPtr<FTiltFiveHMD, ESPMode::ThreadSafe>> GlassesList;
+
+	FRunnableThread* Thread = nullptr;
+	FEvent* WakeEvent = nullptr;
+	std::atomic<bool> bStopRequested{false};
+	std::atomic<bool> bAllowNewConnections{false};
+};
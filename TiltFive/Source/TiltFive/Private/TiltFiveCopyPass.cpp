@@ -0,0 +1,177 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "TiltFiveCopyPass.h"
+
+#include "ClearQuad.h"
+#include "CommonRenderResources.h"
+#include "GlobalShader.h"
+#include "PipelineStateCache.h"
+#include "RHIStaticStates.h"
+#include "RendererInterface.h"
+
+#if UE_VERSION_NEWER_THAN(4, 25, 4)
+
+void FTiltFiveCopyPass::UpdateShaders()
+{
+	// The global shader map only changes when shaders are recompiled, which is rare enough to just look everything up again
+	const FGlobalShaderMap* ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+	if (ShaderMap == CachedShaderMap)
+	{
+		return;
+	}
+
+	VertexShader = TShaderMapRef<FScreenVS>(ShaderMap);
+	PixelShader = TShaderMapRef<FScreenPS>(ShaderMap);
+	PixelShaderSrgbSource = TShaderMapRef<FTiltFiveScreenPSsRGBSource>(ShaderMap);
+	CachedShaderMap = ShaderMap;
+
+	PointSampler = TStaticSamplerState<SF_Point>::GetRHI();
+	BilinearSampler = TStaticSamplerState<SF_Bilinear>::GetRHI();
+
+	// Initializers reference the shaders, so they are rebuilt as well
+	PipelineSets.Reset();
+}
+
+const FTiltFiveCopyPass::FPipelineSet& FTiltFiveCopyPass::FindOrAddPipelines(
+	FRHICommandListImmediate& RHICmdList, FRHITexture2D* TargetTexture)
+{
+	// The initializers capture the render target format, so every target format gets its own set. In practice there are only
+	// two of them, the eye buffers and the spectator back buffer.
+	const EPixelFormat TargetFormat = TargetTexture->GetFormat();
+	const ETextureCreateFlags TargetSrgbFlag =
+		EnumHasAnyFlags(TargetTexture->GetFlags(), TexCreate_SRGB) ? TexCreate_SRGB : TexCreate_None;
+
+	for (const FPipelineSet& PipelineSet : PipelineSets)
+	{
+		if (PipelineSet.TargetFormat == TargetFormat && PipelineSet.TargetSrgbFlag == TargetSrgbFlag)
+		{
+			return PipelineSet;
+		}
+	}
+
+	FPipelineSet& PipelineSet = PipelineSets.AddDefaulted_GetRef();
+	PipelineSet.TargetFormat = TargetFormat;
+	PipelineSet.TargetSrgbFlag = TargetSrgbFlag;
+
+	for (int32 Pipeline = 0; Pipeline < Pipeline_Num; ++Pipeline)
+	{
+		FGraphicsPipelineStateInitializer& GraphicsPSOInit = PipelineSet.Pipelines[Pipeline];
+		RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+		GraphicsPSOInit.BlendState =
+			(Pipeline & Pipeline_Blended)
+				? TStaticBlendState<CW_RGBA, BO_Add, BF_SourceAlpha, BF_InverseSourceAlpha, BO_Add, BF_One, BF_InverseSourceAlpha>::
+					  GetRHI()
+				: TStaticBlendState<>::GetRHI();
+		GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+		GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+		GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+		GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
+		GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+		GraphicsPSOInit.BoundShaderState.PixelShaderRHI =
+			(Pipeline & Pipeline_SrgbSource) ? PixelShaderSrgbSource.GetPixelShader() : PixelShader.GetPixelShader();
+	}
+
+	return PipelineSet;
+}
+
+void FTiltFiveCopyPass::Draw_RenderThread(FRHICommandListImmediate& RHICmdList,
+	IRendererModule& RendererModule,
+	FRHITexture2D* TargetTexture,
+	TArrayView<const FTiltFiveTextureCopy> Copies,
+	bool bClearBlack)
+{
+	check(IsInRenderingThread());
+
+	UpdateShaders();
+
+	// All sources are made readable up front, transitions aren't allowed within the render pass
+	TArray<FRHITransitionInfo, TInlineAllocator<8>> Transitions;
+	Transitions.Add(FRHITransitionInfo(TargetTexture, ERHIAccess::Unknown, ERHIAccess::RTV));
+	for (const FTiltFiveTextureCopy& Copy : Copies)
+	{
+		Transitions.Add(FRHITransitionInfo(Copy.Texture, ERHIAccess::Unknown, ERHIAccess::SRVGraphics));
+	}
+	RHICmdList.Transition(Transitions);
+
+	// Copies may only cover part of the target, so its contents are only thrown away if it is cleared anyway
+	FRHIRenderPassInfo RPInfo(TargetTexture, bClearBlack ? ERenderTargetActions::DontLoad_Store : ERenderTargetActions::Load_Store);
+	RHICmdList.BeginRenderPass(RPInfo, TEXT("TiltFiveHMD_CopyTexture"));
+	{
+		if (bClearBlack)
+		{
+			RHICmdList.SetViewport(0, 0, 0, TargetTexture->GetSizeX(), TargetTexture->GetSizeY(), 1.0f);
+			DrawClearQuad(RHICmdList, FLinearColor::Black);
+		}
+
+		const FPipelineSet& PipelineSet = FindOrAddPipelines(RHICmdList, TargetTexture);
+
+		int32 BoundPipeline = INDEX_NONE;
+		for (const FTiltFiveTextureCopy& Copy : Copies)
+		{
+			if (Copy.DstRect.IsEmpty())
+			{
+				continue;
+			}
+
+			const FIntRect SrcRect =
+				Copy.SrcRect.IsEmpty() ? FIntRect(0, 0, Copy.Texture->GetSizeX(), Copy.Texture->GetSizeY()) : Copy.SrcRect;
+			const float SrcTextureWidth = Copy.Texture->GetSizeX();
+			const float SrcTextureHeight = Copy.Texture->GetSizeY();
+
+			const int32 Pipeline = (EnumHasAnyFlags(Copy.Texture->GetFlags(), TexCreate_SRGB) ? Pipeline_SrgbSource : 0) |
+								   (Copy.bNoAlpha ? 0 : Pipeline_Blended);
+
+			// SetGraphicsPipelineState needs a viewport, set the copy's first
+			RHICmdList.SetViewport(Copy.DstRect.Min.X, Copy.DstRect.Min.Y, 0, Copy.DstRect.Max.X, Copy.DstRect.Max.Y, 1.0f);
+
+			if (Pipeline != BoundPipeline)
+			{
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+				SetGraphicsPipelineState(RHICmdList, PipelineSet.Pipelines[Pipeline]);
+#else
+				SetGraphicsPipelineState(RHICmdList, PipelineSet.Pipelines[Pipeline], 0);
+#endif
+				BoundPipeline = Pipeline;
+			}
+
+			FRHISamplerState* Sampler = SrcRect.Size() == Copy.DstRect.Size() ? PointSampler : BilinearSampler;
+			if (Pipeline & Pipeline_SrgbSource)
+			{
+				PixelShaderSrgbSource->SetParameters(RHICmdList, Sampler, Copy.Texture);
+			}
+			else
+			{
+				PixelShader->SetParameters(RHICmdList, Sampler, Copy.Texture);
+			}
+
+			RendererModule.DrawRectangle(RHICmdList,
+				0,
+				0,
+				Copy.DstRect.Width(),
+				Copy.DstRect.Height(),
+				SrcRect.Min.X / SrcTextureWidth,
+				SrcRect.Min.Y / SrcTextureHeight,
+				SrcRect.Width() / SrcTextureWidth,
+				SrcRect.Height() / SrcTextureHeight,
+				Copy.DstRect.Size(),
+				FIntPoint(1, 1),
+				VertexShader,
+				EDRF_Default);
+		}
+	}
+	RHICmdList.EndRenderPass();
+}
+
+#endif
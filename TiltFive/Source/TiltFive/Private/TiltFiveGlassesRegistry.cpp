@@ -0,0 +1,223 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "TiltFiveGlassesRegistry.h"
+
+#include "HAL/PlatformTime.h"
+#include "TiltFive.h"
+
+// Plugging in glasses is a human-speed event, there's no point in asking the service more often than this
+static constexpr double GlassesRefreshInterval = 0.5;
+
+// How long glasses that couldn't be used sit out at first, and at most after failing over and over
+static constexpr double InitialGlassesCooldown = 2.0;
+static constexpr double MaxGlassesCooldown = 30.0;
+
+void FTiltFiveGlassesRegistry::Refresh_ConnectionThread()
+{
+	const double CurrentTime = FPlatformTime::Seconds();
+	if (CurrentTime - LastRefreshTime < GlassesRefreshInterval)
+	{
+		return;
+	}
+	LastRefreshTime = CurrentTime;
+
+	char ListBuffer[MaxListedGlasses * T5_MAX_STRING_PARAM_LEN];
+	size_t BufferSize = sizeof(ListBuffer);
+
+	const FT5Result Result = t5ListGlasses(FTiltFiveModule::Get().GetContext(), ListBuffer, &BufferSize);
+	ReportServiceResult(Result);
+
+	if (Result != T5_SUCCESS)
+	{
+		// T5_ERROR_NO_SERVICE or T5_ERROR_IO_FAILURE apparently means it is starting up internally,
+		// and we get it soon(tm)
+		UE_CLOG(Result != T5_ERROR_NO_SERVICE && Result != T5_ERROR_IO_FAILURE && Result != T5_ERROR_SERVICE_INCOMPATIBLE,
+			LogTiltFive,
+			Error,
+			TEXT("Failed to retrieve glasses: %S"),
+			t5GetResultMessage(Result));
+		return;
+	}
+
+	// The list is a series of NUL terminated strings, terminated by an empty string. Point into the buffer rather than copying.
+	const char* Listed[MaxListedGlasses];
+	int32 NumListed = 0;
+	for (const char* Current = ListBuffer; Current < ListBuffer + BufferSize && *Current != '\0' && NumListed < MaxListedGlasses;
+		 Current += FCStringAnsi::Strlen(Current) + 1)
+	{
+		Listed[NumListed++] = Current;
+	}
+
+	NumListedGlasses.store(NumListed, std::memory_order_relaxed);
+
+	// Glasses that went away start from scratch when they come back
+	for (int32 CooldownIndex = NumCooldowns - 1; CooldownIndex >= 0; --CooldownIndex)
+	{
+		bool bStillListed = false;
+		for (int32 Index = 0; Index < NumListed && !bStillListed; ++Index)
+		{
+			bStillListed = Cooldowns[CooldownIndex].Identifier.Equals(Listed[Index]);
+		}
+
+		if (!bStillListed)
+		{
+			Cooldowns[CooldownIndex] = Cooldowns[--NumCooldowns];
+		}
+	}
+
+	FRWScopeLock WriteLock(SlotLock, SLT_Write);
+
+	// Free the slots of glasses that went away
+	for (FTiltFiveGlassesIdentifier& SlotIdentifier : SlotIdentifiers)
+	{
+		if (SlotIdentifier.IsEmpty())
+		{
+			continue;
+		}
+
+		bool bStillListed = false;
+		for (int32 Index = 0; Index < NumListed && !bStillListed; ++Index)
+		{
+			bStillListed = SlotIdentifier.Equals(Listed[Index]);
+		}
+
+		if (!bStillListed)
+		{
+			UE_LOG(LogTiltFive, Log, TEXT("Glasses %S are no longer listed"), SlotIdentifier.Id);
+			SlotIdentifier.Id[0] = '\0';
+		}
+	}
+
+	// Hand out the lowest free slot to newly listed glasses, unless they are still cooling down
+	for (int32 Index = 0; Index < NumListed; ++Index)
+	{
+		const int32 CooldownIndex = FindCooldown_ConnectionThread(Listed[Index]);
+		if (CooldownIndex != INDEX_NONE && CurrentTime < Cooldowns[CooldownIndex].RetryTime)
+		{
+			continue;
+		}
+
+		int32 FreeSlot = INDEX_NONE;
+		bool bAlreadyAssigned = false;
+		for (int32 Slot = 0; Slot < NumSlots && !bAlreadyAssigned; ++Slot)
+		{
+			bAlreadyAssigned = SlotIdentifiers[Slot].Equals(Listed[Index]);
+			if (FreeSlot == INDEX_NONE && SlotIdentifiers[Slot].IsEmpty())
+			{
+				FreeSlot = Slot;
+			}
+		}
+
+		if (!bAlreadyAssigned && FreeSlot != INDEX_NONE)
+		{
+			FCStringAnsi::Strncpy(SlotIdentifiers[FreeSlot].Id, Listed[Index], T5_MAX_STRING_PARAM_LEN);
+			UE_LOG(LogTiltFive, Log, TEXT("Assigned glasses %S to player %d"), Listed[Index], FreeSlot + 1);
+		}
+	}
+
+	UpdateOccupiedSlotMask();
+}
+
+void FTiltFiveGlassesRegistry::ReportGlassesUnavailable_ConnectionThread(int32 Slot, const FTiltFiveGlassesIdentifier& Identifier)
+{
+	int32 CooldownIndex = FindCooldown_ConnectionThread(Identifier.Id);
+	if (CooldownIndex == INDEX_NONE && NumCooldowns < MaxListedGlasses)
+	{
+		CooldownIndex = NumCooldowns++;
+		Cooldowns[CooldownIndex].Identifier = Identifier;
+		Cooldowns[CooldownIndex].Duration = 0.0;
+	}
+
+	if (CooldownIndex != INDEX_NONE)
+	{
+		FGlassesCooldown& Cooldown = Cooldowns[CooldownIndex];
+		Cooldown.Duration = FMath::Min(Cooldown.Duration > 0.0 ? Cooldown.Duration * 2.0 : InitialGlassesCooldown, MaxGlassesCooldown);
+		Cooldown.RetryTime = FPlatformTime::Seconds() + Cooldown.Duration;
+		UE_LOG(LogTiltFive, Log, TEXT("Glasses %S are unavailable, retrying in %.0f seconds"), Identifier.Id, Cooldown.Duration);
+	}
+
+	if (Slot < 0 || Slot >= NumSlots)
+	{
+		return;
+	}
+
+	// The next refresh hands the slot to the next listed glasses
+	FRWScopeLock WriteLock(SlotLock, SLT_Write);
+	if (SlotIdentifiers[Slot].Equals(Identifier.Id))
+	{
+		SlotIdentifiers[Slot].Id[0] = '\0';
+		UpdateOccupiedSlotMask();
+	}
+}
+
+void FTiltFiveGlassesRegistry::ReportGlassesReserved_ConnectionThread(const FTiltFiveGlassesIdentifier& Identifier)
+{
+	const int32 CooldownIndex = FindCooldown_ConnectionThread(Identifier.Id);
+	if (CooldownIndex != INDEX_NONE)
+	{
+		Cooldowns[CooldownIndex] = Cooldowns[--NumCooldowns];
+	}
+}
+
+int32 FTiltFiveGlassesRegistry::FindCooldown_ConnectionThread(const ANSICHAR* Id) const
+{
+	for (int32 CooldownIndex = 0; CooldownIndex < NumCooldowns; ++CooldownIndex)
+	{
+		if (Cooldowns[CooldownIndex].Identifier.Equals(Id))
+		{
+			return CooldownIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+void FTiltFiveGlassesRegistry::UpdateOccupiedSlotMask()
+{
+	// Called with the slot lock held for writing
+	uint32 NewOccupiedSlotMask = 0;
+	for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+	{
+		if (!SlotIdentifiers[Slot].IsEmpty())
+		{
+			NewOccupiedSlotMask |= 1u << Slot;
+		}
+	}
+	OccupiedSlotMask.store(NewOccupiedSlotMask, std::memory_order_relaxed);
+}
+
+bool FTiltFiveGlassesRegistry::GetSlotIdentifier(int32 Slot, FTiltFiveGlassesIdentifier& OutIdentifier) const
+{
+	if (Slot < 0 || Slot >= NumSlots)
+	{
+		return false;
+	}
+
+	FRWScopeLock ReadLock(SlotLock, SLT_ReadOnly);
+	OutIdentifier = SlotIdentifiers[Slot];
+	return !OutIdentifier.IsEmpty();
+}
+
+void FTiltFiveGlassesRegistry::ReportServiceResult(FT5Result Result)
+{
+	if (Result == T5_ERROR_SERVICE_INCOMPATIBLE)
+	{
+		bVersionCompatible = false;
+		UE_LOG(LogTiltFive, Error, TEXT("Version incompatible, needs service upgrade"));
+	}
+	else if (Result == T5_SUCCESS)
+	{
+		bVersionCompatible = true;
+	}
+}
@@ -76,29 +76,57 @@ void ATiltFiveManager::TrackPlayers() {
 	}
 	return;
 }
+
+void ATiltFiveManager::BroadcastParamChanges() {
+	TSharedPtr<class FTiltFiveXRBase, ESPMode::ThreadSafe> TiltFiveXRSystem = StaticCastSharedPtr<class FTiltFiveXRBase, class IXRTrackingSystem, ESPMode::ThreadSafe>(GEngine->XRSystem);
+	const FTiltFiveParamWatcher& ParamWatcher = TiltFiveXRSystem->ParamWatcher;
+
+	const uint64 SystemParamsVersion = ParamWatcher.GetSystemParamsVersion();
+	if (SystemParamsVersion != LastSystemParamsVersion) {
+		LastSystemParamsVersion = SystemParamsVersion;
+		OnSystemParamsChanged.Broadcast();
+	}
+
+	for (int32 PlayerIndex = 0; PlayerIndex < FTiltFiveParamWatcher::NumSlots; PlayerIndex++) {
+		const uint64 GlassesParamsVersion = ParamWatcher.GetGlassesParamsVersion(PlayerIndex);
+		if (GlassesParamsVersion != LastGlassesParamsVersions[PlayerIndex]) {
+			LastGlassesParamsVersions[PlayerIndex] = GlassesParamsVersion;
+			OnGlassesParamsChanged.Broadcast(PlayerIndex);
+		}
+	}
+}
+
 // Called every frame
 void ATiltFiveManager::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 	TrackPlayers();
+	BroadcastParamChanges();
 	TSharedPtr<class FTiltFiveXRBase, ESPMode::ThreadSafe> TiltFiveXRSystem = StaticCastSharedPtr<class FTiltFiveXRBase, class IXRTrackingSystem, ESPMode::ThreadSafe>(GEngine->XRSystem);
 	TiltFiveXRSystem->SetSpectatedPlayer(spectatedPlayer);
 	for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> Hmd : TiltFiveXRSystem->GlassesList) {
+		float* PlayerFOV;
 		if (Hmd->DeviceId == 0) {
-			Hmd->OverrideFOV(player1FOV);
+			PlayerFOV = &player1FOV;
 		}
 		else if (Hmd->DeviceId == 1) {
-			Hmd->OverrideFOV(player2FOV);
+			PlayerFOV = &player2FOV;
 		}
 		else if (Hmd->DeviceId == 2) {
-			Hmd->OverrideFOV(player3FOV);
+			PlayerFOV = &player3FOV;
 		}
 		else if (Hmd->DeviceId == 3) {
-			Hmd->OverrideFOV(player4FOV);
+			PlayerFOV = &player4FOV;
 		}
 		else {
 			continue;
 		}
+
+		// Only push FOV changes, so whatever else overrides the FOV isn't undone every frame
+		if (*PlayerFOV != LastAppliedFOVs[Hmd->DeviceId]) {
+			Hmd->OverrideFOV(*PlayerFOV);
+			LastAppliedFOVs[Hmd->DeviceId] = *PlayerFOV;
+		}
 	}
 }
 
@@ -0,0 +1,199 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "TiltFiveParamWatcher.h"
+
+#include "TiltFive.h"
+
+// More parameters than the service currently has, so new ones don't overflow the change list
+static constexpr uint16 MaxChangedParams = 16;
+
+static FT5Result ReadSystemParam(T5_ParamSys Param, FTiltFiveSystemParams& Params)
+{
+	const T5_Context Context = FTiltFiveModule::Get().GetContext();
+
+	switch (Param)
+	{
+	case kT5_ParamSys_UTF8_Service_Version:
+	{
+		size_t BufferSize = sizeof(Params.ServiceVersion);
+		return t5GetSystemUtf8Param(Context, Param, Params.ServiceVersion, &BufferSize);
+	}
+
+	case kT5_ParamSys_Integer_CPL_AttRequired:
+	{
+		int64_t Value = 0;
+		const FT5Result Result = t5GetSystemIntegerParam(Context, Param, &Value);
+		if (Result == T5_SUCCESS)
+		{
+			Params.bUiRequestingAttention = Value != 0;
+		}
+		return Result;
+	}
+
+	default:
+		// A parameter newer than this plugin
+		return T5_SUCCESS;
+	}
+}
+
+static FT5Result ReadGlassesParam(FT5GlassesPtr Glasses, T5_ParamGlasses Param, FTiltFiveGlassesParams& Params)
+{
+	switch (Param)
+	{
+	case kT5_ParamGlasses_Float_IPD:
+	{
+		double Value = 0.0;
+		const FT5Result Result = t5GetGlassesFloatParam(Glasses, 0, Param, &Value);
+		if (Result == T5_SUCCESS)
+		{
+			Params.IPD = static_cast<float>(Value);
+		}
+		return Result;
+	}
+
+	case kT5_ParamGlasses_UTF8_FriendlyName:
+	{
+		size_t BufferSize = sizeof(Params.FriendlyName);
+		return t5GetGlassesUtf8Param(Glasses, 0, Param, Params.FriendlyName, &BufferSize);
+	}
+
+	default:
+		// A parameter newer than this plugin
+		return T5_SUCCESS;
+	}
+}
+
+void FTiltFiveParamWatcher::UpdateSystemParams_ConnectionThread()
+{
+	const T5_Context Context = FTiltFiveModule::Get().GetContext();
+	FTiltFiveSystemParams& Params = SystemParams_ConnectionThread;
+
+	T5_ParamSys ChangedParams[MaxChangedParams];
+	uint16 NumChangedParams = MaxChangedParams;
+
+	// The first call only starts tracking changes and never reports any, so it has to happen before the initial read to not miss
+	// anything that changes in between.
+	FT5Result Result = t5GetChangedSystemParams(Context, ChangedParams, &NumChangedParams);
+	if (Result != T5_SUCCESS)
+	{
+		UE_LOG(LogTiltFive, VeryVerbose, TEXT("Failed to get changed system parameters: %S"), t5GetResultMessage(Result));
+		return;
+	}
+
+	if (!Params.bValid)
+	{
+		ChangedParams[0] = kT5_ParamSys_UTF8_Service_Version;
+		ChangedParams[1] = kT5_ParamSys_Integer_CPL_AttRequired;
+		NumChangedParams = 2;
+	}
+	else if (NumChangedParams == 0)
+	{
+		return;
+	}
+
+	for (uint16 Index = 0; Index < NumChangedParams; ++Index)
+	{
+		Result = ReadSystemParam(ChangedParams[Index], Params);
+		if (Result != T5_SUCCESS)
+		{
+			// The service is probably still starting up, we'll read everything again on the next update
+			UE_LOG(LogTiltFive, Verbose, TEXT("Failed to read system parameter %d: %S"), ChangedParams[Index], t5GetResultMessage(Result));
+			Params.bValid = false;
+			return;
+		}
+	}
+
+	if (!Params.bValid)
+	{
+		UE_LOG(LogTiltFive, Log, TEXT("Tilt Five service version: %S"), Params.ServiceVersion);
+	}
+
+	Params.bValid = true;
+	SystemParams.Push(Params);
+}
+
+bool FTiltFiveParamWatcher::UpdateGlassesParams_ConnectionThread(int32 Slot,
+	FT5GlassesPtr Glasses,
+	FCriticalSection& ExclusiveGroup1CriticalSection,
+	bool bReadAll)
+{
+	check(Slot >= 0 && Slot < NumSlots);
+	FTiltFiveGlassesParams& Params = GlassesParams_ConnectionThread[Slot];
+
+	FScopeLock ScopeLock(&ExclusiveGroup1CriticalSection);
+
+	T5_ParamGlasses ChangedParams[MaxChangedParams];
+	uint16 NumChangedParams = MaxChangedParams;
+
+	// As for the system parameters, the change list has to be set up before the initial read
+	FT5Result Result = t5GetChangedGlassesParams(Glasses, ChangedParams, &NumChangedParams);
+	if (Result != T5_SUCCESS)
+	{
+		UE_LOG(LogTiltFive, Verbose, TEXT("Failed to get changed parameters of glasses %d: %S"), Slot, t5GetResultMessage(Result));
+		return false;
+	}
+
+	if (bReadAll)
+	{
+		Params = FTiltFiveGlassesParams{};
+		ChangedParams[0] = kT5_ParamGlasses_Float_IPD;
+		ChangedParams[1] = kT5_ParamGlasses_UTF8_FriendlyName;
+		NumChangedParams = 2;
+	}
+	else if (NumChangedParams == 0)
+	{
+		return false;
+	}
+
+	for (uint16 Index = 0; Index < NumChangedParams; ++Index)
+	{
+		// Keep whatever we had for parameters that can't be read, it's still the best guess
+		Result = ReadGlassesParam(Glasses, ChangedParams[Index], Params);
+		UE_CLOG(Result != T5_SUCCESS,
+			LogTiltFive,
+			Error,
+			TEXT("Failed to read parameter %d of glasses %d: %S"),
+			ChangedParams[Index],
+			Slot,
+			t5GetResultMessage(Result));
+	}
+
+	Params.bValid = true;
+	GlassesParams[Slot].Push(Params);
+	return true;
+}
+
+void FTiltFiveParamWatcher::ClearGlassesParams_ConnectionThread(int32 Slot)
+{
+	check(Slot >= 0 && Slot < NumSlots);
+
+	GlassesParams_ConnectionThread[Slot] = FTiltFiveGlassesParams{};
+	GlassesParams[Slot].Push(GlassesParams_ConnectionThread[Slot]);
+}
+
+bool FTiltFiveParamWatcher::GetSystemParams(FTiltFiveSystemParams& OutParams) const
+{
+	return SystemParams.ReadLatest(OutParams) && OutParams.bValid;
+}
+
+bool FTiltFiveParamWatcher::GetGlassesParams(int32 Slot, FTiltFiveGlassesParams& OutParams) const
+{
+	if (Slot < 0 || Slot >= NumSlots)
+	{
+		return false;
+	}
+
+	return GlassesParams[Slot].ReadLatest(OutParams) && OutParams.bValid;
+}
@@ -71,6 +71,26 @@ void TiltFiveSpectatorController::QueueDebugCanvasLayerID(int32 LayerID)
 	DebugCanvasLayerIDs.Add(LayerID);
 }
 
+void TiltFiveSpectatorController::SetSpectatorLayout(const FTiltFiveSpectatorLayout& Layout)
+{
+	FScopeLock FrameLock(&NewSpectatorScreenModeLock);
+	NewSpectatorLayout = Layout;
+	bNewSpectatorLayoutPending = true;
+}
+
+FTiltFiveSpectatorLayout TiltFiveSpectatorController::GetSpectatorLayout() const
+{
+	if (IsInRenderingThread())
+	{
+		return SpectatorLayout_RenderThread;
+	}
+	else
+	{
+		FScopeLock Lock(&NewSpectatorScreenModeLock);
+		return NewSpectatorLayout;
+	}
+}
+
 FSpectatorScreenRenderDelegate* TiltFiveSpectatorController::GetSpectatorScreenRenderDelegate_RenderThread()
 {
 	return &SpectatorScreenDelegate_RenderThread;
@@ -190,6 +210,12 @@ void TiltFiveSpectatorController::UpdateSpectatorScreenMode_RenderThread()
 	{
 		FScopeLock FrameLock(&NewSpectatorScreenModeLock);
 		NewMode = NewSpectatorScreenMode;
+
+		if (bNewSpectatorLayoutPending)
+		{
+			SpectatorLayout_RenderThread = NewSpectatorLayout;
+			bNewSpectatorLayoutPending = false;
+		}
 	}
 
 	if (NewMode == SpectatorScreenMode_RenderThread)
@@ -257,6 +283,7 @@ void TiltFiveSpectatorController::RenderSpectatorScreen_RenderThread(FRHICommand
 	{
 		const FIntRect DstRect(0, 0, BackBuffer->GetSizeX(), BackBuffer->GetSizeY());
 
+		TArray<FTiltFiveTextureCopy, TInlineAllocator<4>> Copies;
 		for (int32 LayerID : DebugCanvasLayerIDs)
 		{
 			FTextureRHIRef LayerTexture = nullptr, HMDNull = nullptr;
@@ -267,23 +294,90 @@ void TiltFiveSpectatorController::RenderSpectatorScreen_RenderThread(FRHICommand
 				check(LayerTexture2D.IsValid());  // Debug canvas layer should be a 2d layer
 				const FIntRect LayerRect(0, 0, LayerTexture2D->GetSizeX(), LayerTexture2D->GetSizeY());
 				const FIntRect DstRectLetterboxed = GetLetterboxedDestRect(LayerRect, DstRect);
-				HMDDevice->CopyTexture_RenderThread(RHICmdList, LayerTexture2D, LayerRect, BackBuffer, DstRectLetterboxed, false, false);
+				Copies.Add({LayerTexture2D, LayerRect, DstRectLetterboxed, false});
 			}
 		}
+		if (Copies.Num() > 0)
+		{
+			HMDDevice->CopyTextures_RenderThread(RHICmdList, BackBuffer, Copies, false);
+		}
 		DebugCanvasLayerIDs.Empty();
 	}
 }
 
+bool TiltFiveSpectatorController::IsMultiPlayerLayout_RenderThread() const
+{
+	check(IsInRenderingThread());
+
+	return SpectatorLayout_RenderThread.Mode != ETiltFiveSpectatorLayoutMode::SinglePlayer &&
+		SpectatorScreenMode_RenderThread != ESpectatorScreenMode::Disabled;
+}
+
+void TiltFiveSpectatorController::RenderSpectatorPlayers_RenderThread(FRHICommandListImmediate& RHICmdList, FRHITexture2D* BackBuffer, TArrayView<FRHITexture2D* const> PlayerTextures, int32 SpectatedPlayer)
+{
+	SCOPED_NAMED_EVENT_TEXT("RenderSpectatorPlayers_RenderThread()", FColor::Magenta);
+
+	check(IsInRenderingThread());
+
+	// The players to show, in order, skipping those without an eye texture
+	TArray<int32, TInlineAllocator<8>> Players;
+	if (SpectatorLayout_RenderThread.Players.Num() > 0)
+	{
+		for (int32 PlayerIndex : SpectatorLayout_RenderThread.Players)
+		{
+			if (PlayerTextures.IsValidIndex(PlayerIndex) && PlayerTextures[PlayerIndex])
+			{
+				Players.AddUnique(PlayerIndex);
+			}
+		}
+	}
+	else
+	{
+		if (PlayerTextures.IsValidIndex(SpectatedPlayer) && PlayerTextures[SpectatedPlayer])
+		{
+			Players.Add(SpectatedPlayer);
+		}
+		for (int32 PlayerIndex = 0; PlayerIndex < PlayerTextures.Num(); ++PlayerIndex)
+		{
+			if (PlayerTextures[PlayerIndex])
+			{
+				Players.AddUnique(PlayerIndex);
+			}
+		}
+	}
+
+	const FIntRect TargetRect(0, 0, BackBuffer->GetSizeX(), BackBuffer->GetSizeY());
+	TArray<FIntRect> TileRects;
+	GetLayoutTileRects(SpectatorLayout_RenderThread, Players.Num(), TargetRect, TileRects);
+
+	TArray<FTiltFiveTextureCopy, TInlineAllocator<8>> Tiles;
+	for (int32 TileIndex = 0; TileIndex < Players.Num(); ++TileIndex)
+	{
+		FRHITexture2D* EyeTexture = PlayerTextures[Players[TileIndex]];
+		const FIntRect EyeRect(0, 0, EyeTexture->GetSizeX(), EyeTexture->GetSizeY());
+		if (TileRects[TileIndex].Area() > 0 && EyeRect.Area() > 0)
+		{
+			Tiles.Add({EyeTexture, GetEyeCroppedToFitRect(FVector2D(0.5f, 0.5f), EyeRect, TileRects[TileIndex]), TileRects[TileIndex]});
+		}
+	}
+
+	SCOPED_DRAW_EVENT(RHICmdList, SpectatorScreen)
+	HMDDevice->CopyTextures_RenderThread(RHICmdList, BackBuffer, Tiles, true);
+
+	// The debug canvas belongs to the single player view
+	DebugCanvasLayerIDs.Empty();
+}
+
 FIntRect TiltFiveSpectatorController::GetFullFlatEyeRect_RenderThread(FTexture2DRHIRef EyeTexture)
 {
 	return HMDDevice->GetFullFlatEyeRect_RenderThread(EyeTexture);
 }
 
-void TiltFiveSpectatorController::CopyEmulatedLayers(FRHICommandListImmediate& RHICmdList, FTexture2DRHIRef TargetTexture, const FIntRect SrcRect, const FIntRect DstRect)
+void TiltFiveSpectatorController::AddEmulatedLayersCopy(TArray<FTiltFiveTextureCopy, TInlineAllocator<4>>& Copies, const FIntRect SrcRect, const FIntRect DstRect)
 {
 	if (StereoLayersTexture)
 	{
-		HMDDevice->CopyTexture_RenderThread(RHICmdList, StereoLayersTexture, SrcRect, TargetTexture, DstRect, false, false);
+		Copies.Add({StereoLayersTexture, SrcRect, DstRect, false});
 	}
 	StereoLayersTexture = nullptr;
 }
@@ -293,8 +387,10 @@ void TiltFiveSpectatorController::RenderSpectatorModeUndistorted(FRHICommandList
 	const FIntRect SrcRect(0, 0, EyeTexture->GetSizeX(), EyeTexture->GetSizeY());
 	const FIntRect DstRect(0, 0, TargetTexture->GetSizeX(), TargetTexture->GetSizeY());
 
-	HMDDevice->CopyTexture_RenderThread(RHICmdList, EyeTexture, SrcRect, TargetTexture, DstRect, false, true);
-	CopyEmulatedLayers(RHICmdList, TargetTexture, SrcRect, DstRect);
+	TArray<FTiltFiveTextureCopy, TInlineAllocator<4>> Copies;
+	Copies.Add({EyeTexture, SrcRect, DstRect, true});
+	AddEmulatedLayersCopy(Copies, SrcRect, DstRect);
+	HMDDevice->CopyTextures_RenderThread(RHICmdList, TargetTexture, Copies, false);
 }
 
 void TiltFiveSpectatorController::RenderSpectatorModeDistorted(FRHICommandListImmediate& RHICmdList, FTexture2DRHIRef TargetTexture, FTexture2DRHIRef EyeTexture, FTexture2DRHIRef OtherTexture, FVector2D WindowSize)
@@ -309,8 +405,10 @@ void TiltFiveSpectatorController::RenderSpectatorModeSingleEye(FRHICommandListIm
 	const FIntRect SrcRect(0, 0, EyeTexture->GetSizeX() / 2, EyeTexture->GetSizeY());
 	const FIntRect DstRect(0, 0, TargetTexture->GetSizeX(), TargetTexture->GetSizeY());
 
-	HMDDevice->CopyTexture_RenderThread(RHICmdList, EyeTexture, SrcRect, TargetTexture, DstRect, false, true);
-	CopyEmulatedLayers(RHICmdList, TargetTexture, SrcRect, DstRect);
+	TArray<FTiltFiveTextureCopy, TInlineAllocator<4>> Copies;
+	Copies.Add({EyeTexture, SrcRect, DstRect, true});
+	AddEmulatedLayersCopy(Copies, SrcRect, DstRect);
+	HMDDevice->CopyTextures_RenderThread(RHICmdList, TargetTexture, Copies, false);
 }
 
 void TiltFiveSpectatorController::RenderSpectatorModeSingleEyeLetterboxed(FRHICommandListImmediate& RHICmdList, FTexture2DRHIRef TargetTexture, FTexture2DRHIRef EyeTexture, FTexture2DRHIRef OtherTexture, FVector2D WindowSize)
@@ -319,8 +417,10 @@ void TiltFiveSpectatorController::RenderSpectatorModeSingleEyeLetterboxed(FRHICo
 	const FIntRect DstRect(0, 0, TargetTexture->GetSizeX(), TargetTexture->GetSizeY());
 	const FIntRect DstRectLetterboxed = GetLetterboxedDestRect(SrcRect, DstRect);
 
-	HMDDevice->CopyTexture_RenderThread(RHICmdList, EyeTexture, SrcRect, TargetTexture, DstRectLetterboxed, true, true);
-	CopyEmulatedLayers(RHICmdList, TargetTexture, SrcRect, DstRectLetterboxed);
+	TArray<FTiltFiveTextureCopy, TInlineAllocator<4>> Copies;
+	Copies.Add({EyeTexture, SrcRect, DstRectLetterboxed, true});
+	AddEmulatedLayersCopy(Copies, SrcRect, DstRectLetterboxed);
+	HMDDevice->CopyTextures_RenderThread(RHICmdList, TargetTexture, Copies, true);
 }
 
 void TiltFiveSpectatorController::RenderSpectatorModeSingleEyeCroppedToFill(FRHICommandListImmediate& RHICmdList, FTexture2DRHIRef TargetTexture, FTexture2DRHIRef EyeTexture, FTexture2DRHIRef OtherTexture, FVector2D WindowSize)
@@ -331,8 +431,10 @@ void TiltFiveSpectatorController::RenderSpectatorModeSingleEyeCroppedToFill(FRHI
 
 	const FIntRect SrcCroppedToFitRect = GetEyeCroppedToFitRect(HMDDevice->GetEyeCenterPoint_RenderThread(EStereoscopicEye::eSSE_LEFT_EYE), SrcRect, WindowRect);
 
-	HMDDevice->CopyTexture_RenderThread(RHICmdList, EyeTexture, SrcCroppedToFitRect, TargetTexture, DstRect, false, true);
-	CopyEmulatedLayers(RHICmdList, TargetTexture, SrcCroppedToFitRect, DstRect);
+	TArray<FTiltFiveTextureCopy, TInlineAllocator<4>> Copies;
+	Copies.Add({EyeTexture, SrcCroppedToFitRect, DstRect, true});
+	AddEmulatedLayersCopy(Copies, SrcCroppedToFitRect, DstRect);
+	HMDDevice->CopyTextures_RenderThread(RHICmdList, TargetTexture, Copies, false);
 }
 
 void TiltFiveSpectatorController::RenderSpectatorModeTexture(FRHICommandListImmediate& RHICmdList, FTexture2DRHIRef TargetTexture, FTexture2DRHIRef EyeTexture, FTexture2DRHIRef OtherTexture, FVector2D WindowSize)
@@ -366,18 +468,20 @@ void TiltFiveSpectatorController::RenderSpectatorModeMirrorAndTexture(FRHIComman
 
 	const bool bClearBlack = SpectatorScreenModeTexturePlusEyeLayout_RenderThread.bClearBlack;
 
+	TArray<FTiltFiveTextureCopy, TInlineAllocator<4>> Copies;
 	if (SpectatorScreenModeTexturePlusEyeLayout_RenderThread.bDrawEyeFirst)
 	{
-		HMDDevice->CopyTexture_RenderThread(RHICmdList, EyeTexture, CroppedEyeSrcRect, TargetTexture, EyeDstRect, bClearBlack, true);
-		CopyEmulatedLayers(RHICmdList, TargetTexture, CroppedEyeSrcRect, EyeDstRect);
-		HMDDevice->CopyTexture_RenderThread(RHICmdList, OtherTextureLocal, OtherSrcRect, TargetTexture, OtherDstRect, false, !SpectatorScreenModeTexturePlusEyeLayout_RenderThread.bUseAlpha);
+		Copies.Add({EyeTexture, CroppedEyeSrcRect, EyeDstRect, true});
+		AddEmulatedLayersCopy(Copies, CroppedEyeSrcRect, EyeDstRect);
+		Copies.Add({OtherTextureLocal, OtherSrcRect, OtherDstRect, !SpectatorScreenModeTexturePlusEyeLayout_RenderThread.bUseAlpha});
 	}
 	else
 	{
-		HMDDevice->CopyTexture_RenderThread(RHICmdList, OtherTextureLocal, OtherSrcRect, TargetTexture, OtherDstRect, bClearBlack, true);
-		HMDDevice->CopyTexture_RenderThread(RHICmdList, EyeTexture, CroppedEyeSrcRect, TargetTexture, EyeDstRect, false, true);
-		CopyEmulatedLayers(RHICmdList, TargetTexture, CroppedEyeSrcRect, EyeDstRect);
+		Copies.Add({OtherTextureLocal, OtherSrcRect, OtherDstRect, true});
+		Copies.Add({EyeTexture, CroppedEyeSrcRect, EyeDstRect, true});
+		AddEmulatedLayersCopy(Copies, CroppedEyeSrcRect, EyeDstRect);
 	}
+	HMDDevice->CopyTextures_RenderThread(RHICmdList, TargetTexture, Copies, bClearBlack);
 }
 
 FRHITexture2D* TiltFiveSpectatorController::GetFallbackRHITexture() const
@@ -473,3 +577,56 @@ FIntRect TiltFiveSpectatorController::GetLetterboxedDestRect(const FIntRect& Src
 
 	return OutRect;
 }
+
+void TiltFiveSpectatorController::GetLayoutTileRects(const FTiltFiveSpectatorLayout& Layout, int32 NumTiles, const FIntRect& TargetRect, TArray<FIntRect>& OutTileRects)
+{
+	OutTileRects.Reset();
+	if (NumTiles <= 0)
+	{
+		return;
+	}
+
+	const int32 Padding = FMath::Max(Layout.Padding, 0);
+
+	if (Layout.Mode == ETiltFiveSpectatorLayoutMode::PictureInPicture)
+	{
+		OutTileRects.Add(TargetRect);
+
+		// Insets keep the aspect ratio of the window and line up from the bottom right corner
+		int32 InsetHeight = FMath::RoundToInt(TargetRect.Height() * FMath::Clamp(Layout.InsetScale, 0.05f, 0.5f));
+		int32 InsetWidth = TargetRect.Width() * InsetHeight / FMath::Max(TargetRect.Height(), 1);
+
+		// With many players a large inset scale would push the insets out of the window, so they shrink to fit side by side
+		const int32 NumInsets = NumTiles - 1;
+		if (NumInsets > 0)
+		{
+			const int32 MaxInsetWidth = FMath::Max((TargetRect.Width() - Padding * (NumInsets + 1)) / NumInsets, 0);
+			if (InsetWidth > MaxInsetWidth)
+			{
+				InsetHeight = InsetHeight * MaxInsetWidth / InsetWidth;
+				InsetWidth = MaxInsetWidth;
+			}
+		}
+
+		FIntPoint InsetMax(TargetRect.Max.X - Padding, TargetRect.Max.Y - Padding);
+		for (int32 TileIndex = 1; TileIndex < NumTiles; ++TileIndex)
+		{
+			OutTileRects.Add(FIntRect(InsetMax - FIntPoint(InsetWidth, InsetHeight), InsetMax));
+			InsetMax.X -= InsetWidth + Padding;
+		}
+		return;
+	}
+
+	const int32 NumColumns = Layout.GridColumns > 0 ? FMath::Min(Layout.GridColumns, NumTiles) : FMath::CeilToInt(FMath::Sqrt((float)NumTiles));
+	const int32 NumRows = FMath::DivideAndRoundUp(NumTiles, NumColumns);
+
+	const int32 TileWidth = FMath::Max((TargetRect.Width() - Padding * (NumColumns + 1)) / NumColumns, 0);
+	const int32 TileHeight = FMath::Max((TargetRect.Height() - Padding * (NumRows + 1)) / NumRows, 0);
+	for (int32 TileIndex = 0; TileIndex < NumTiles; ++TileIndex)
+	{
+		const int32 Column = TileIndex % NumColumns;
+		const int32 Row = TileIndex / NumColumns;
+		const FIntPoint TileMin(TargetRect.Min.X + Padding + Column * (TileWidth + Padding), TargetRect.Min.Y + Padding + Row * (TileHeight + Padding));
+		OutTileRects.Add(FIntRect(TileMin, TileMin + FIntPoint(TileWidth, TileHeight)));
+	}
+}
@@ -13,11 +13,18 @@
 #include "XRThreadUtils.h"
 #include "HMD/TiltFiveHMD.h"
 #include "HMD/TiltFiveXRCamera.h"
+#include "TiltFiveConnectionThread.h"
 #include "TiltFiveSpectatorController.h"
 #include "TiltFiveManager.h"
+#include "TiltFiveSettings.h"
+#include "TiltFiveStats.h"
 #include "IXRCamera.h"
 #include "Engine/GameInstance.h"
 
+#if TILTFIVE_WITH_VULKAN
+#include "IVulkanDynamicRHI.h"
+#endif
+
 #include <thread>
 
 #define ENGINE_SPECIFIC_HEADER_INNER(Prefix, Major, Minor, Suffix) \
@@ -29,6 +36,88 @@
 
 #include ENGINE_SPECIFIC_HEADER(HMD/Engine/TiltFiveHMD)
 
+DEFINE_STAT(STAT_TiltFivePresent);
+DEFINE_STAT(STAT_TiltFiveSubmitMs0);
+DEFINE_STAT(STAT_TiltFiveSubmitMs1);
+DEFINE_STAT(STAT_TiltFiveSubmitMs2);
+DEFINE_STAT(STAT_TiltFiveSubmitMs3);
+
+// The graphics API the glasses are driven with. The RHI can't change while the engine runs, so it is only looked up once.
+static ET5GraphicsAPI GetGlassesGraphicsApi()
+{
+	static const ET5GraphicsAPI GraphicsApi = []()
+	{
+#if UE_VERSION_OLDER_THAN(5, 1, 0)
+		const FString RHIName = GDynamicRHI->GetName();
+		if (RHIName == TEXT("D3D11"))
+		{
+			return kT5_GraphicsApi_D3D11;
+		}
+		if (RHIName == TEXT("OpenGL"))
+		{
+			return kT5_GraphicsApi_GL;
+		}
+#else
+		switch (RHIGetInterfaceType())
+		{
+		case ERHIInterfaceType::D3D11:
+			return kT5_GraphicsApi_D3D11;
+		case ERHIInterfaceType::OpenGL:
+			return kT5_GraphicsApi_GL;
+#if TILTFIVE_WITH_VULKAN
+		case ERHIInterfaceType::Vulkan:
+			return kT5_GraphicsApi_Vulkan;
+#endif
+		default:
+			break;
+		}
+#endif
+		UE_LOG(LogTiltFive, Error, TEXT("The %s RHI isn't supported by the glasses"), GDynamicRHI->GetName());
+		return kT5_GraphicsApi_None;
+	}();
+
+	return GraphicsApi;
+}
+
+// The handle of an eye texture as t5SendFrameToGlasses expects it for the graphics API in use. Vulkan wants pointers to VkImage
+// handles instead, which are only filled in right before the frame is sent, see SubmitPacket_RHIThread.
+static void* GetGlassesTextureHandle(FRHITexture* Texture)
+{
+#if TILTFIVE_WITH_VULKAN
+	if (GetGlassesGraphicsApi() == kT5_GraphicsApi_Vulkan)
+	{
+		return nullptr;
+	}
+#endif
+	return Texture->GetNativeResource();
+}
+
+// Whether region copies move texels of the given format into eye textures unchanged: the formats are the same, or at least map to
+// the same native format on this RHI
+static bool IsCopyCompatibleWithEyeTextures(EPixelFormat Format)
+{
+	if (Format == EyeTextureFormat)
+	{
+		return true;
+	}
+	return Format < PF_MAX && GPixelFormats[Format].Supported && GPixelFormats[EyeTextureFormat].Supported &&
+		GPixelFormats[Format].PlatformFormat == GPixelFormats[EyeTextureFormat].PlatformFormat &&
+		GPixelFormats[Format].BlockBytes == GPixelFormats[EyeTextureFormat].BlockBytes;
+}
+
+#if TILTFIVE_WITH_VULKAN
+// T5_GraphicsContextVulkan takes pointers to the engine's Vulkan handles rather than the handles themselves. The handles are
+// kept here for as long as the RHI they come from, in case the service holds on to the pointers past context initialization.
+struct FTiltFiveVulkanHandles
+{
+	VkInstance Instance = VK_NULL_HANDLE;
+	VkPhysicalDevice PhysicalDevice = VK_NULL_HANDLE;
+	VkDevice Device = VK_NULL_HANDLE;
+	VkQueue Queue = VK_NULL_HANDLE;
+};
+static FTiltFiveVulkanHandles VulkanHandles_RHIThread;
+#endif
+
 FTiltFiveXRBase::FTiltFiveXRBase(IARSystemSupport* InARImplementation)
 	: FXRTrackingSystemBase(InARImplementation)
 {
@@ -38,14 +127,18 @@ FTiltFiveXRBase::FTiltFiveXRBase(IARSystemSupport* InARImplementation)
 
 FTiltFiveXRBase::~FTiltFiveXRBase()
 {
+	// The connection thread has to be gone before the glasses it drives
+	ConnectionThread.Reset();
 	GlassesList.Empty();
 }
 
 void FTiltFiveXRBase::Startup()
 {
 	for (int32 i = 0; i < GMaxNumTiltFiveGlasses; i++) {
-		GlassesList.Add(MakeShared<class FTiltFiveHMD, ESPMode::ThreadSafe>(this, i));
+		GlassesList.Add(MakeShared<class FTiltFiveHMD, ESPMode::ThreadSafe>(this, GlassesRegistry, ParamWatcher, i));
 	}
+	ConnectionThread = MakeUnique<FTiltFiveConnectionThread>(GlassesRegistry, ParamWatcher, GlassesList);
+	ConnectionThread->Start();
 	CustomPresent = new FTiltFiveCustomPresent(GlassesList);
 	TiltFiveSceneViewExtension = FSceneViewExtensions::NewExtension<FTiltFiveSceneViewExtension>(this);
 	SpectatorScreenController = MakeUnique<TiltFiveSpectatorController>(this);
@@ -65,7 +158,35 @@ bool FTiltFiveXRBase::IsHeadTrackingAllowed() const
 
 bool FTiltFiveXRBase::IsVersionCompatible() const
 {
-	return GlassesList[0]->bVersionCompatible;
+	return GlassesRegistry.IsVersionCompatible();
+}
+
+const FTiltFiveAtlasLayout& FTiltFiveXRBase::GetAtlasLayout() const
+{
+	static const FTiltFiveAtlasLayout DefaultAtlasLayout;
+
+	const FTiltFiveFrameState* FrameState = IsInRenderingThread() ? FrameState_RenderThread : FrameState_GameThread;
+	return FrameState ? FrameState->Atlas : DefaultAtlasLayout;
+}
+
+bool FTiltFiveXRBase::GetNativeEyeSize(FIntPoint& OutEyeSize) const
+{
+	for (const TSharedPtr<FTiltFiveHMD, ESPMode::ThreadSafe>& HMD : GlassesList)
+	{
+		if (HMD->GetNativeEyeSize(OutEyeSize))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FTiltFiveXRBase::SetSpectatorLayout(const FTiltFiveSpectatorLayout& Layout)
+{
+	if (SpectatorScreenController)
+	{
+		SpectatorScreenController->SetSpectatorLayout(Layout);
+	}
 }
 
 void FTiltFiveXRBase::SetSpectatedPlayer(int32 deviceId) const {
@@ -191,14 +312,14 @@ EHMDTrackingOrigin::Type FTiltFiveXRBase::GetTrackingOrigin() const
 
 float FTiltFiveXRBase::GetWorldToMetersScale() const
 {
-	FTiltFiveWorldStatePtr CurrentState;
+	const FTiltFiveFrameState* CurrentState;
 	if (IsInRenderingThread())
 	{
-		CurrentState = RenderThreadWorldState;
+		CurrentState = FrameState_RenderThread;
 	}
 	else if (IsInGameThread())
 	{
-		CurrentState = CurrentWorldState;
+		CurrentState = FrameState_GameThread;
 	}
 	else
 	{
@@ -206,7 +327,7 @@ float FTiltFiveXRBase::GetWorldToMetersScale() const
 		return 100.0f;
 	}
 
-	if (!CurrentState.IsValid())
+	if (!CurrentState || !CurrentState->bHasWorldToMetersScale)
 	{
 		// Fallback to default value
 		return 100.0f;
@@ -253,55 +374,63 @@ bool FTiltFiveXRBase::OnStartGameFrame(FWorldContext& WorldContext)
 		return false;
 	}
 
-	const float CurrentTime = static_cast<float>(FApp::GetCurrentTime());
-	// If the current time for some reason gets reset, we also reset our timer,
-	// otherwise we may wait a very long time here
-	if (LastGlassesUpdate > CurrentTime)
-	{
-		LastGlassesUpdate = CurrentTime;
-	}
-	// Poll Glasses once per second
-	if (LastGlassesUpdate + 1.0f < CurrentTime)
-	{
-		LastGlassesUpdate = CurrentTime;
+	// Glasses are only connected once a game is running, from then on the connection thread keeps looking for them
+	ConnectionThread->AllowNewConnections();
 
-		for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> Hmd : GlassesList) {
-			Hmd->ConditionalInitializeGlasses();
+	// Apply and announce what the connection thread did since the last frame
+	for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> Hmd : GlassesList) {
+		FTiltFiveGlassesStateTransition Transition;
+		while (Hmd->DequeueStateTransition(Transition))
+		{
+			Hmd->ApplyStateTransition_GameThread(Transition.NewState);
+			OnGlassesStateChanged.Broadcast(Hmd->DeviceId, Transition.OldState, Transition.NewState);
 		}
 	}
 
-	CurrentWorldState.Reset();
+	FTiltFiveFrameState& FrameState = FrameStates.BeginFrame_GameThread(GFrameCounter);
+	const AWorldSettings* WorldSettings = World->GetWorldSettings();
+	FrameState.bHasWorldToMetersScale = WorldSettings != nullptr;
+	FrameState.WorldToMetersScale = WorldSettings ? WorldSettings->WorldToMeters : 100.0f;
+	FrameState_GameThread = &FrameState;
 
-	if (const AWorldSettings* WorldSettings = WorldContext.World()->GetWorldSettings())
-	{
-		FTiltFiveWorldState WorldState;
-		WorldState.WorldToMetersScale = WorldSettings->WorldToMeters;
-		CurrentWorldState = MakeShared<FTiltFiveWorldState, ESPMode::ThreadSafe>(WorldState);
-	}
+	uint32 EnabledPlayerMask = 0;
 
-	for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> Hmd : GlassesList) {
-		if (Hmd->IsHMDEnabled()) {
-			Hmd->CurrentWorldState = CurrentWorldState;
-			Hmd->UpdateCachedGlassesPose_GameThread();
-			FQuat GlassesOrientation;
-			FVector GlassesPosition;
-			TOptional<FTransform> MaybeRelativeGlassesTransform;
-
-			if (GetCurrentPose(Hmd->DeviceId, GlassesOrientation, GlassesPosition))
-			{
-				MaybeRelativeGlassesTransform = FTransform(GlassesOrientation, GlassesPosition);
-			}
-			FTiltFiveWorldStatePtr RenderThreadCopy = MakeShared<FTiltFiveWorldState, ESPMode::ThreadSafe>(*CurrentWorldState);
+	for (const TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe>& Hmd : GlassesList) {
+		FTiltFiveFrameGlassesState& GlassesState = FrameState.Glasses[Hmd->DeviceId];
+		Hmd->FrameState_GameThread = &FrameState;
 
-			ExecuteOnRenderThread_DoNotWait(
-				[this, RenderThreadCopy, MaybeRelativeGlassesTransform, Hmd](FRHICommandListImmediate& RHICmdList)
-				{
-					Hmd->RenderThreadWorldState = RenderThreadCopy;
-					Hmd->MaybeRelativeGlassesTransform_RenderThread = MaybeRelativeGlassesTransform;
-				});
+		GlassesState.bEnabled = Hmd->IsHMDEnabled();
+		if (!GlassesState.bEnabled) {
+			continue;
 		}
+		EnabledPlayerMask |= 1u << Hmd->DeviceId;
+
+		Hmd->UpdateCachedGlassesPose_GameThread();
+		FQuat GlassesOrientation;
+		FVector GlassesPosition;
+
+		if (GetCurrentPose(Hmd->DeviceId, GlassesOrientation, GlassesPosition))
+		{
+			GlassesState.MaybeRelativeGlassesTransform = FTransform(GlassesOrientation, GlassesPosition);
+		}
+		GlassesState.PoseTime = Hmd->CachedGlassesPoseTime_GameThread;
+		GlassesState.IPD = Hmd->GetInterpupillaryDistance();
+		GlassesState.FOV = Hmd->FOV;
 	}
 
+	FrameState.DefaultViewPlayerIndex = FTiltFiveAtlasLayout::FindDefaultViewPlayer(EnabledPlayerMask);
+
+	FIntPoint EyeSize = FIntPoint(DefaultEyeSizeX, DefaultEyeSizeY);
+	GetNativeEyeSize(EyeSize);
+	FrameState.Atlas.Build(EyeSize, EnabledPlayerMask, FrameState.DefaultViewPlayerIndex);
+
+	// Only the pointer travels with the render command, which keeps the capture small enough to not allocate
+	ENQUEUE_RENDER_COMMAND(TiltFiveSetFrameState)(
+		[this, &FrameState](FRHICommandListImmediate& RHICmdList)
+		{
+			SetFrameState_RenderThread(FrameState);
+		});
+
 	if (SpectatorScreenController)
 	{
 		SpectatorScreenController->SetSpectatorScreenMode(ESpectatorScreenMode::Undistorted);
@@ -312,6 +441,23 @@ bool FTiltFiveXRBase::OnStartGameFrame(FWorldContext& WorldContext)
 	return false;
 }
 
+void FTiltFiveXRBase::SetFrameState_RenderThread(const FTiltFiveFrameState& FrameState)
+{
+	check(IsInRenderingThread());
+
+	FrameState_RenderThread = &FrameState;
+
+	for (const TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe>& Hmd : GlassesList) {
+		const FTiltFiveFrameGlassesState& GlassesState = FrameState.Glasses[Hmd->DeviceId];
+		Hmd->FrameState_RenderThread = &FrameState;
+
+		if (GlassesState.bEnabled) {
+			Hmd->MaybeRelativeGlassesTransform_RenderThread = GlassesState.MaybeRelativeGlassesTransform;
+			Hmd->GameThreadPoseTime_RenderThread = GlassesState.PoseTime;
+		}
+	}
+}
+
 void FTiltFiveXRBase::OnBeginRendering_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily)
 {
 	check(IsInRenderingThread());
@@ -369,41 +515,13 @@ void FTiltFiveXRBase::AdjustViewRect(enum EStereoscopicPass StereoPass, int32& X
 	Y = Rect.Min.Y;
 	SizeX = Rect.Width();
 	SizeY = Rect.Height();
-	stereoPassCount++;
-	int activeGlassesCount = 0;
-	for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> HMD : GlassesList) {
-		if (HMD->IsHMDEnabled()) {
-			activeGlassesCount++;
-		}
-	}
-	if (stereoPassCount >= (activeGlassesCount * 2)) {
-		stereoPassCount = 0;
-	}
 }
 #else
 void FTiltFiveXRBase::AdjustViewRect(int32 ViewIndex, int32& X, int32& Y, uint32& SizeX, uint32& SizeY) const
 {
-	if (ViewIndex != EStereoscopicEye::eSSE_RIGHT_EYE && ViewIndex != EStereoscopicEye::eSSE_LEFT_EYE)
-	{
-		return;
-	}
-	
-	const int32 EyeIndex = ViewIndex == EStereoscopicEye::eSSE_RIGHT_EYE ? 1 : 0;
-	FIntRect Rect = GlassesList[stereoPassCount/2]->EyeInfos[EyeIndex].SourceEyeRect;
-	X = Rect.Min.X;
-	Y = Rect.Min.Y;
-	SizeX = Rect.Width();
-	SizeY = Rect.Height();
-	stereoPassCount++;
-	int activeGlassesCount = 0;
-	for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> HMD : GlassesList) {
-		if (HMD->IsHMDEnabled()) {
-			activeGlassesCount++;
-		}
-	}
-	if (stereoPassCount >= (activeGlassesCount*2)) {
-		stereoPassCount = 0;
-	}
+	FTiltFiveViewRoute Route;
+	RouteStereoView(ViewIndex, INDEX_NONE, Route);
+	AdjustViewRect(ViewIndex, X, Y, SizeX, SizeY, Route.PlayerIndex);
 }
 
 void FTiltFiveXRBase::AdjustViewRect(int32 ViewIndex, int32& X, int32& Y, uint32& SizeX, uint32& SizeY, int32 playerIndex) const
@@ -413,8 +531,9 @@ void FTiltFiveXRBase::AdjustViewRect(int32 ViewIndex, int32& X, int32& Y, uint32
 		return;
 	}
 
-	const int32 EyeIndex = ViewIndex == EStereoscopicEye::eSSE_RIGHT_EYE ? 1 : 0;
-	FIntRect Rect = GlassesList[playerIndex]->EyeInfos[EyeIndex].SourceEyeRect;
+	FTiltFiveViewRoute Route;
+	RouteStereoView(ViewIndex, playerIndex, Route);
+	const FIntRect Rect = GetAtlasLayout().GetEyeRect(Route.PlayerIndex, Route.EyeIndex);
 	X = Rect.Min.X;
 	Y = Rect.Min.Y;
 	SizeX = Rect.Width();
@@ -448,37 +567,15 @@ FMatrix FTiltFiveXRBase::GetStereoProjectionMatrix(const enum EStereoscopicPass
 #else
 FMatrix FTiltFiveXRBase::GetStereoProjectionMatrix(const int32 ViewIndex) const
 {
-	const int32 EyeIndex = ViewIndex == EStereoscopicEye::eSSE_RIGHT_EYE ? 1 : 0;
-
-	const float HalfFov = FMath::DegreesToRadians(GlassesList[stereoPassCount]->FOV) / 2.f;
-	const float HalfFovTan = FMath::Tan(HalfFov);
-	const float InWidth = GlassesList[stereoPassCount]->EyeInfos[EyeIndex].DestEyeRect.Width();
-	const float InHeight = GlassesList[stereoPassCount]->EyeInfos[EyeIndex].DestEyeRect.Height();
-	const float XS = 1.0f / HalfFovTan;
-	const float YS = InWidth / HalfFovTan / InHeight;
-
-	const float InNearZ = GNearClippingPlane;
-	return FMatrix(FPlane(XS, 0.0f, 0.0f, 0.0f),
-		FPlane(0.0f, YS, 0.0f, 0.0f),
-		FPlane(0.0f, 0.0f, 0.0f, 1.0f),
-		FPlane(0.0f, 0.0f, InNearZ, 0.0f));
+	FTiltFiveViewRoute Route;
+	RouteStereoView(ViewIndex, INDEX_NONE, Route);
+	return GetStereoProjectionMatrix(ViewIndex, Route.PlayerIndex);
 }
 FMatrix FTiltFiveXRBase::GetStereoProjectionMatrix(const int32 ViewIndex, const int32 playerIndex) const
 {
-	const int32 EyeIndex = ViewIndex == EStereoscopicEye::eSSE_RIGHT_EYE ? 1 : 0;
-
-	const float HalfFov = FMath::DegreesToRadians(GlassesList[playerIndex]->FOV) / 2.f;
-	const float HalfFovTan = FMath::Tan(HalfFov);
-	const float InWidth = GlassesList[playerIndex]->EyeInfos[EyeIndex].DestEyeRect.Width();
-	const float InHeight = GlassesList[playerIndex]->EyeInfos[EyeIndex].DestEyeRect.Height();
-	const float XS = 1.0f / HalfFovTan;
-	const float YS = InWidth / HalfFovTan / InHeight;
-
-	const float InNearZ = GNearClippingPlane;
-	return FMatrix(FPlane(XS, 0.0f, 0.0f, 0.0f),
-		FPlane(0.0f, YS, 0.0f, 0.0f),
-		FPlane(0.0f, 0.0f, 0.0f, 1.0f),
-		FPlane(0.0f, 0.0f, InNearZ, 0.0f));
+	FTiltFiveViewRoute Route;
+	RouteStereoView(ViewIndex, playerIndex, Route);
+	return GlassesList[Route.PlayerIndex]->GetProjection().ProjectionMatrix;
 }
 #endif
 
@@ -508,28 +605,102 @@ void FTiltFiveXRBase::InitCanvasFromView(class FSceneView* InView, class UCanvas
 	Canvas->ViewProjectionMatrix = HMDView.ViewMatrices.GetViewProjectionMatrix();
 }
 
+void FTiltFiveXRBase::CopyTextures_RenderThread(FRHICommandListImmediate& RHICmdList,
+	FRHITexture2D* DstTexture,
+	TArrayView<const FTiltFiveTextureCopy> Copies,
+	bool bClearBlack) const
+{
+	check(IsInRenderingThread());
+
+#if UE_VERSION_NEWER_THAN(4, 25, 4)
+	CopyPass_RenderThread.Draw_RenderThread(RHICmdList, *RendererModule, DstTexture, Copies, bClearBlack);
+#else
+	// Engines without the transition API copy one by one, one render pass each
+	for (const FTiltFiveTextureCopy& Copy : Copies)
+	{
+#if UE_VERSION_NEWER_THAN(4, 20, 3)
+		CopyTexture_RenderThread(RHICmdList, Copy.Texture, Copy.SrcRect, DstTexture, Copy.DstRect, bClearBlack, Copy.bNoAlpha);
+#else
+		CopyTexture_RenderThread(RHICmdList, Copy.Texture, Copy.SrcRect, DstTexture, Copy.DstRect, bClearBlack);
+#endif
+		bClearBlack = false;
+	}
+#endif
+}
+
 void FTiltFiveXRBase::RenderTexture_RenderThread(class FRHICommandListImmediate& RHICmdList,
 	class FRHITexture* BackBuffer,
 	class FRHITexture* SrcTexture,
 	FVector2D WindowSize) const
 {
+	const FTiltFiveAtlasLayout& Atlas = GetAtlasLayout();
+
+	// When the scene target is the one allocated by AllocateRenderTargetTexture its format is copy compatible with the eye textures,
+	// and the eyes are copied out of it by the copy engine rather than with a shader blit (PSO, render pass and draw) per eye
+#if UE_VERSION_NEWER_THAN(4, 25, 4)
+	const bool bCopyRegions = IsCopyCompatibleWithEyeTextures(SrcTexture->GetFormat()) && SrcTexture->GetNumSamples() == 1;
+#else
+	const bool bCopyRegions = false;
+#endif
+	const ETextureCreateFlags EyeTextureSRGBFlag =
+		bCopyRegions && EnumHasAnyFlags(SrcTexture->GetFlags(), TexCreate_SRGB) ? TexCreate_SRGB : TexCreate_None;
+
+	// OpenGL glasses can take both eyes as the slices of one array texture, which can only be filled by region copies
+	const bool bEyeTextureArrays = bCopyRegions && GetDefault<UTiltFiveSettings>()->bUseEyeTextureArraysOnOpenGL &&
+		GetGlassesGraphicsApi() == kT5_GraphicsApi_GL;
+	UpdateEyeTextures_RenderThread(Atlas, EyeTextureSRGBFlag, bEyeTextureArrays);
+
+#if UE_VERSION_NEWER_THAN(4, 25, 4)
+	if (bCopyRegions)
+	{
+		RHICmdList.Transition(FRHITransitionInfo(SrcTexture, ERHIAccess::Unknown, ERHIAccess::CopySrc));
+	}
+#endif
+
 	for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> HMD : GlassesList) {
-		if(HMD->IsHMDEnabled())
+		// Texture arrays can only be filled by region copies
+		if (!HMD->IsHMDEnabled() || !Atlas.HasPlayer(HMD->DeviceId) || (HMD->EyeTextureArray && !bCopyRegions))
+		{
+			continue;
+		}
+
 		for (int32 EyeIndex = 0; EyeIndex < NumEyeRenderTargets; ++EyeIndex)
 		{
-			const FIntRect DestEyeRect(
-				0, 0, HMD->EyeInfos[EyeIndex].BufferedRTRHI->GetSizeX(), HMD->EyeInfos[EyeIndex].BufferedRTRHI->GetSizeY());
-			CopyTexture_RenderThread(RHICmdList,
-				SrcTexture,
-				HMD->EyeInfos[EyeIndex].SourceEyeRect,
-				HMD->EyeInfos[EyeIndex].BufferedRTRHI,
-				DestEyeRect,
-				false
+			const FIntRect SrcEyeRect = Atlas.GetEyeRect(HMD->DeviceId, EyeIndex);
+#if UE_VERSION_NEWER_THAN(4, 25, 4)
+			if (bCopyRegions)
+			{
+				FRHITexture* EyeTexture = HMD->EyeTextureArray ? HMD->EyeTextureArray.GetReference() : HMD->EyeInfos[EyeIndex].BufferedRTRHI.GetReference();
+
+				FRHICopyTextureInfo CopyInfo;
+				CopyInfo.Size = FIntVector(Atlas.EyeSize.X, Atlas.EyeSize.Y, 1);
+				CopyInfo.SourcePosition = FIntVector(SrcEyeRect.Min.X, SrcEyeRect.Min.Y, 0);
+				CopyInfo.DestSliceIndex = HMD->EyeTextureArray ? EyeIndex : 0;
+
+				RHICmdList.Transition(FRHITransitionInfo(EyeTexture, ERHIAccess::Unknown, ERHIAccess::CopyDest));
+				RHICmdList.CopyTexture(SrcTexture, EyeTexture, CopyInfo);
+
+				if (HMD->EyeTextureArray)
+				{
+					continue;
+				}
+			}
+			else
+#endif
+			{
+				const FIntRect DestEyeRect(FIntPoint::ZeroValue, Atlas.EyeSize);
+				CopyTexture_RenderThread(RHICmdList,
+					SrcTexture,
+					SrcEyeRect,
+					HMD->EyeInfos[EyeIndex].BufferedRTRHI,
+					DestEyeRect,
+					false
 #if UE_VERSION_NEWER_THAN(4, 20, 3)
-				,
-				true
+					,
+					true
 #endif
-			);
+				);
+			}
 
 #if UE_VERSION_NEWER_THAN(4, 25, 4)
 			RHICmdList.Transition(FRHITransitionInfo(HMD->EyeInfos[EyeIndex].BufferedSRVRHI, ERHIAccess::WritableMask, ERHIAccess::SRVMask));
@@ -538,10 +709,227 @@ void FTiltFiveXRBase::RenderTexture_RenderThread(class FRHICommandListImmediate&
 			RHICmdList.TransitionResources(EResourceTransitionAccess::EReadable, &Texture, 1);
 #endif
 		}
+
+#if UE_VERSION_NEWER_THAN(4, 25, 4)
+		if (HMD->EyeTextureArray)
+		{
+			RHICmdList.Transition(FRHITransitionInfo(HMD->EyeTextureArray, ERHIAccess::CopyDest, ERHIAccess::SRVMask));
+		}
+#endif
 	}
-	if (SpectatorScreenController)
+
+#if UE_VERSION_NEWER_THAN(4, 25, 4)
+	// Leave the scene target readable, as the blit would have
+	if (bCopyRegions)
+	{
+		RHICmdList.Transition(FRHITransitionInfo(SrcTexture, ERHIAccess::CopySrc, ERHIAccess::SRVGraphics));
+	}
+#endif
+
+	EnqueueSubmitPackets_RenderThread(RHICmdList);
+
+	if (SpectatorScreenController && SpectatorScreenController->IsMultiPlayerLayout_RenderThread())
+	{
+		FRHITexture2D* PlayerTextures[GMaxNumTiltFiveGlasses] = {};
+		for (int32 PlayerIndex = 0; PlayerIndex < GlassesList.Num() && PlayerIndex < GMaxNumTiltFiveGlasses; ++PlayerIndex)
+		{
+			PlayerTextures[PlayerIndex] = GlassesList[PlayerIndex]->EyeInfos[0].BufferedSRVRHI;
+		}
+		SpectatorScreenController->RenderSpectatorPlayers_RenderThread(
+			RHICmdList, BackBuffer, PlayerTextures, currentSpectatedPlayer);
+		return;
+	}
+
+	// Players without glasses have no eye textures, show whoever is rendered instead. Eye texture arrays can't be spectated, in that
+	// case the spectator sees the whole scene target.
+	FTexture2DRHIRef SpectatedTexture = GlassesList[currentSpectatedPlayer]->EyeInfos[0].BufferedSRVRHI;
+	for (int32 PlayerIndex = 0; !SpectatedTexture && PlayerIndex < GlassesList.Num(); ++PlayerIndex)
 	{
-		SpectatorScreenController->RenderSpectatorScreen_RenderThread(RHICmdList, BackBuffer, GlassesList[currentSpectatedPlayer]->EyeInfos[0].BufferedSRVRHI, WindowSize);
+		SpectatedTexture = GlassesList[PlayerIndex]->EyeInfos[0].BufferedSRVRHI;
+	}
+	if (!SpectatedTexture && bEyeTextureArrays)
+	{
+		SpectatedTexture = SrcTexture->GetTexture2D();
+	}
+
+	if (SpectatorScreenController && SpectatedTexture)
+	{
+		SpectatorScreenController->RenderSpectatorScreen_RenderThread(RHICmdList, BackBuffer, SpectatedTexture, WindowSize);
+	}
+}
+
+void FTiltFiveXRBase::EnqueueSubmitPackets_RenderThread(FRHICommandListImmediate& RHICmdList) const
+{
+	check(IsInRenderingThread());
+
+	FTiltFiveSubmitPackets Packets;
+	for (const TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe>& HMD : GlassesList) {
+		FTiltFiveSubmitPacket& Packet = Packets[HMD->DeviceId];
+		Packet.bValid = false;
+
+		if (!HMD->IsHMDEnabled() || !HMD->ExclusiveGlasses_RenderThread || !HMD->MaybeRelativeGlassesTransform_RenderThread.IsSet() ||
+			!HMD->FrameState_RenderThread || !(HMD->EyeTextureArray || HMD->EyeInfos[0].BufferedSRVRHI))
+		{
+			continue;
+		}
+
+		const FTiltFiveFrameGlassesState& GlassesFrameState = HMD->FrameState_RenderThread->Glasses[HMD->DeviceId];
+
+		FQuat GlassesOrientation = HMD->MaybeRelativeGlassesTransform_RenderThread->GetRotation();
+		FVector GlassesPosition = HMD->MaybeRelativeGlassesTransform_RenderThread->GetTranslation();
+
+		FT5FrameInfo& FrameInfo = Packet.FrameInfo;
+
+		const float WorldToMetersScale = HMD->GetWorldToMetersScale();
+
+		float IPD_UWRLD = GlassesFrameState.IPD * WorldToMetersScale;
+
+		FTiltFiveHMD::ConvertPositionToHardware(
+			GlassesPosition - GlassesOrientation.GetRightVector() * IPD_UWRLD * 0.5f, FrameInfo.posLVC_GBD, WorldToMetersScale);
+		FTiltFiveHMD::ConvertPositionToHardware(
+			GlassesPosition + GlassesOrientation.GetRightVector() * IPD_UWRLD * 0.5f, FrameInfo.posRVC_GBD, WorldToMetersScale);
+
+		FTiltFiveHMD::ConvertRotationToHardware(GlassesOrientation, FrameInfo.rotToLVC_GBD);
+		FTiltFiveHMD::ConvertRotationToHardware(GlassesOrientation, FrameInfo.rotToRVC_GBD);
+
+		// Same projection the frame was rendered with
+		const FTiltFiveProjection& Projection = HMD->GetProjection();
+		FrameInfo.vci.startX_VCI = Projection.StartX_VCI;
+		FrameInfo.vci.startY_VCI = Projection.StartY_VCI;
+		FrameInfo.vci.width_VCI = Projection.Width_VCI;
+		FrameInfo.vci.height_VCI = Projection.Height_VCI;
+
+		FrameInfo.isUpsideDown = true;
+		if (HMD->EyeTextureArray)
+		{
+			// The slices to use are passed along with the graphics context
+			const FIntVector ArraySize = HMD->EyeTextureArray->GetSizeXYZ();
+			FrameInfo.isSrgb = EnumHasAnyFlags(HMD->EyeTextureArray->GetFlags(), TexCreate_SRGB) != 0;
+			FrameInfo.leftTexHandle = GetGlassesTextureHandle(HMD->EyeTextureArray);
+			FrameInfo.rightTexHandle = nullptr;
+			FrameInfo.texWidth_PIX = ArraySize.X;
+			FrameInfo.texHeight_PIX = ArraySize.Y;
+			Packet.Textures[0] = HMD->EyeTextureArray;
+		}
+		else
+		{
+			FrameInfo.isSrgb = EnumHasAnyFlags(HMD->EyeInfos[0].BufferedSRVRHI->GetFlags(), TexCreate_SRGB) != 0;
+			FrameInfo.leftTexHandle = GetGlassesTextureHandle(HMD->EyeInfos[0].BufferedSRVRHI);
+			FrameInfo.rightTexHandle = GetGlassesTextureHandle(HMD->EyeInfos[1].BufferedSRVRHI);
+			FrameInfo.texWidth_PIX = HMD->EyeInfos[0].BufferedSRVRHI->GetSizeX();
+			FrameInfo.texHeight_PIX = HMD->EyeInfos[0].BufferedSRVRHI->GetSizeY();
+			Packet.Textures[0] = HMD->EyeInfos[0].BufferedSRVRHI;
+			Packet.Textures[1] = HMD->EyeInfos[1].BufferedSRVRHI;
+		}
+
+		Packet.bValid = true;
+		Packet.DeviceId = HMD->DeviceId;
+		Packet.Glasses = HMD->ExclusiveGlasses_RenderThread;
+		Packet.bUsesTextureArray = HMD->EyeTextureArray.IsValid();
+		Packet.RenderThreadPoseTime = HMD->CachedGlassesPoseTime_RenderThread;
+		Packet.GameThreadPoseTime = HMD->GameThreadPoseTime_RenderThread;
+	}
+
+	// Runs after the copies into the eye textures, and before the present that sends them
+	RHICmdList.EnqueueLambda(
+		[CustomPresent = CustomPresent, Packets](FRHICommandListImmediate&)
+		{
+			CustomPresent->SetSubmitPackets_RHIThread(Packets);
+		});
+}
+
+void FTiltFiveXRBase::UpdateEyeTextures_RenderThread(const FTiltFiveAtlasLayout& Atlas, ETextureCreateFlags SRGBFlag, bool bTextureArrays) const
+{
+	check(IsInRenderingThread());
+
+	for (const TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe>& HMD : GlassesList) {
+		const bool bInAtlas = Atlas.HasPlayer(HMD->DeviceId);
+
+		// Graphics contexts are initialized for one way of submitting, so glasses keep the one they were first seen with
+		if (HMD->TextureModeGlasses_RenderThread != HMD->ExclusiveGlasses_RenderThread)
+		{
+			HMD->TextureModeGlasses_RenderThread = HMD->ExclusiveGlasses_RenderThread;
+			HMD->bUseTextureArray_RenderThread = bTextureArrays;
+		}
+		const bool bUseArray = HMD->bUseTextureArray_RenderThread;
+
+		if (HMD->EyeTextureArray &&
+			(!bInAtlas || !bUseArray || FIntPoint(HMD->EyeTextureArray->GetSizeXYZ().X, HMD->EyeTextureArray->GetSizeXYZ().Y) != Atlas.EyeSize ||
+				EnumHasAnyFlags(HMD->EyeTextureArray->GetFlags(), TexCreate_SRGB) != (SRGBFlag == TexCreate_SRGB)))
+		{
+			HMD->EyeTextureArray = nullptr;
+		}
+
+		if (bInAtlas && bUseArray && !HMD->EyeTextureArray)
+		{
+#if UE_VERSION_OLDER_THAN(5, 3, 0)
+			FRHIResourceCreateInfo CreateInfo{ TEXT("TiltFiveEyeArrayRT") };
+			HMD->EyeTextureArray = RHICreateTexture2DArray(Atlas.EyeSize.X,
+				Atlas.EyeSize.Y,
+				NumEyeRenderTargets,
+				EyeTextureFormat,
+				1,
+				1,
+				TexCreate_ShaderResource | SRGBFlag,
+				CreateInfo);
+#else
+			const FRHITextureCreateDesc Desc =
+				FRHITextureCreateDesc::Create2DArray(TEXT("TiltFiveEyeArrayRT"))
+				.SetExtent(Atlas.EyeSize)
+				.SetArraySize(NumEyeRenderTargets)
+				.SetFormat(EyeTextureFormat)
+				.SetFlags(ETextureCreateFlags::ShaderResource | SRGBFlag);
+			HMD->EyeTextureArray = RHICreateTexture(Desc);
+#endif
+		}
+
+		for (int32 EyeIndex = 0; EyeIndex < NumEyeRenderTargets; ++EyeIndex)
+		{
+			FTiltFiveEyeInfo& EyeInfo = HMD->EyeInfos[EyeIndex];
+
+			if (EyeInfo.BufferedRTRHI &&
+				(!bInAtlas || bUseArray || EyeInfo.BufferedRTRHI->GetSizeXY() != Atlas.EyeSize ||
+					EnumHasAnyFlags(EyeInfo.BufferedRTRHI->GetFlags(), TexCreate_SRGB) != (SRGBFlag == TexCreate_SRGB)))
+			{
+				EyeInfo.BufferedRTRHI = nullptr;
+				EyeInfo.BufferedSRVRHI = nullptr;
+			}
+
+			if (!bInAtlas || bUseArray || EyeInfo.BufferedRTRHI)
+			{
+				continue;
+			}
+
+#if !UE_BUILD_SHIPPING
+			EyeInfo.DebugName = FString::Printf(TEXT("TiltFiveEyeRT%d_%d"), HMD->DeviceId, EyeIndex);
+			const TCHAR* DebugName = *EyeInfo.DebugName;
+#else
+			const TCHAR* DebugName = TEXT("TiltFiveEyeRT");
+#endif
+
+#if UE_VERSION_OLDER_THAN(5, 3, 0)
+			FRHIResourceCreateInfo CreateInfo{ DebugName };
+			RHICreateTargetableShaderResource2D(Atlas.EyeSize.X,
+				Atlas.EyeSize.Y,
+				EyeTextureFormat,
+				1,
+				SRGBFlag,
+				TexCreate_RenderTargetable,
+				false,
+				CreateInfo,
+				EyeInfo.BufferedRTRHI,
+				EyeInfo.BufferedSRVRHI);
+#else
+			const FRHITextureCreateDesc Desc =
+				FRHITextureCreateDesc::Create2D(DebugName)
+				.SetExtent(Atlas.EyeSize)
+				.SetFormat(EyeTextureFormat)
+				.SetFlags(ETextureCreateFlags::RenderTargetable | ETextureCreateFlags::ShaderResource | SRGBFlag);
+			FTexture2DRHIRef Texture = RHICreateTexture(Desc);
+			EyeInfo.BufferedRTRHI = Texture;
+			EyeInfo.BufferedSRVRHI = Texture;
+#endif
+		}
 	}
 }
 
@@ -551,22 +939,9 @@ IStereoRenderTargetManager* FTiltFiveXRBase::GetRenderTargetManager()
 }
 
 void FTiltFiveXRBase::CalculateStereoViewOffset(const int32 ViewIndex, FRotator& ViewRotation, const float WorldToMeters, FVector& ViewLocation) {
-	
-	TSharedPtr<class IXRCamera, ESPMode::ThreadSafe> HMDCamera = GetXRCamera(stereoPassCount);
-	if (HMDCamera.IsValid())
-	{
-		HMDCamera->CalculateStereoCameraOffset(ViewIndex, ViewRotation, ViewLocation);
-	}
-	stereoPassCount++;
-	int activeGlassesCount = 0;
-	for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> HMD : GlassesList) {
-		if (HMD->IsHMDEnabled()) {
-			activeGlassesCount++;
-		}
-	}
-	if (stereoPassCount >= (activeGlassesCount * 2)) {
-		stereoPassCount = 0;
-	}
+	FTiltFiveViewRoute Route;
+	RouteStereoView(ViewIndex, INDEX_NONE, Route);
+	CalculateStereoViewOffset(ViewIndex, ViewRotation, WorldToMeters, ViewLocation, Route.PlayerIndex);
 }
 
 void FTiltFiveXRBase::CalculateStereoViewOffset(const int32 ViewIndex, FRotator& ViewRotation, const float WorldToMeters, FVector& ViewLocation, int32 playerIndex) {
@@ -577,6 +952,24 @@ void FTiltFiveXRBase::CalculateStereoViewOffset(const int32 ViewIndex, FRotator&
 	}
 }
 
+bool FTiltFiveViewRoute::Route(int32 ViewIndex, int32 PlayerIndex, int32 DefaultViewPlayerIndex, FTiltFiveViewRoute& OutRoute)
+{
+	if (PlayerIndex == INDEX_NONE)
+	{
+		PlayerIndex = DefaultViewPlayerIndex;
+	}
+
+	OutRoute.PlayerIndex = FMath::Clamp(PlayerIndex, 0, FTiltFiveGlassesRegistry::NumSlots - 1);
+	OutRoute.EyeIndex = ViewIndex == EStereoscopicEye::eSSE_RIGHT_EYE ? 1 : 0;
+	return ViewIndex == EStereoscopicEye::eSSE_LEFT_EYE || ViewIndex == EStereoscopicEye::eSSE_RIGHT_EYE;
+}
+
+bool FTiltFiveXRBase::RouteStereoView(int32 ViewIndex, int32 PlayerIndex, FTiltFiveViewRoute& OutRoute) const
+{
+	const FTiltFiveFrameState* FrameState = IsInRenderingThread() ? FrameState_RenderThread : FrameState_GameThread;
+	return FTiltFiveViewRoute::Route(ViewIndex, PlayerIndex, FrameState ? FrameState->DefaultViewPlayerIndex : 0, OutRoute);
+}
+
 uint32 FTiltFiveXRBase::CreateLayer(const FLayerDesc& InLayerDesc)
 {
 	unimplemented();
@@ -628,51 +1021,41 @@ bool FTiltFiveXRBase::AllocateRenderTargetTexture(uint32 Index,
 	FTexture2DRHIRef& OutShaderResourceTexture,
 	uint32 NumSamples /*= 1*/)
 {
-	FRHIResourceCreateInfo CreateInfo{ TEXT("TiltFiveCreateInfo") };
-	const int32 EyeSizeX = SizeX / 2;
-	const int32 EyeSizeY = SizeY / 4;
-	GlassesList[0]->WidthToHeight = (float)EyeSizeX / (float)EyeSizeY;
-
-#if UE_VERSION_NEWER_THAN(5, 2, 0)
-	FRHITextureCreateDesc Desc =
-		FRHITextureCreateDesc::Create2D(TEXT("TiltFiveCreateInfo"))
-		.SetExtent(EyeSizeX, EyeSizeY)
-		.SetFormat(PF_R8G8B8A8)
-		.SetFlags(ETextureCreateFlags::RenderTargetable | ETextureCreateFlags::ShaderResource);
-#endif
-
-	for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> HMD : GlassesList) {
-		for (int32 EyeIndex = 0; EyeIndex < NumEyeRenderTargets; ++EyeIndex)
-		{
-#if !UE_BUILD_SHIPPING
-			HMD->EyeInfos[EyeIndex].DebugName = FString::Printf(TEXT("TiltFiveEyeRT%d"), EyeIndex);
-			CreateInfo.DebugName = *HMD->EyeInfos[EyeIndex].DebugName;
-#endif
-			HMD->EyeInfos[EyeIndex].SourceEyeRect = FIntRect(EyeSizeX * EyeIndex, (EyeSizeY * HMD->DeviceId), EyeSizeX * EyeIndex + EyeSizeX, (EyeSizeY * HMD->DeviceId) + EyeSizeY);
-			HMD->EyeInfos[EyeIndex].DestEyeRect = FIntRect(0, 0, EyeSizeX, EyeSizeY);
+	// Multisampled targets can't be copied from directly, and other formats (e.g. HDR or 10 bit back buffers) would have to be
+	// converted. The engine allocates those as it asked for them and the eyes are blitted out of them.
+	const EPixelFormat PixelFormat = static_cast<EPixelFormat>(Format);
+	if (NumSamples > 1 || !IsCopyCompatibleWithEyeTextures(PixelFormat))
+	{
+		return false;
+	}
 
-#if UE_VERSION_NEWER_THAN(5, 2, 0)
-			FTexture2DRHIRef Texture = RHICreateTexture(Desc);
-			HMD->EyeInfos[EyeIndex].BufferedRTRHI = Texture;
-			HMD->EyeInfos[EyeIndex].BufferedSRVRHI = Texture;
+	// The scene target is only allocated here so its format is known to match, RenderTexture_RenderThread then copies the eyes out
+	// with plain region copies
+#if UE_VERSION_OLDER_THAN(5, 3, 0)
+	FRHIResourceCreateInfo CreateInfo{ TEXT("TiltFiveSceneRT") };
+	RHICreateTargetableShaderResource2D(SizeX,
+		SizeY,
+		PixelFormat,
+		NumMips,
+		Flags,
+		TargetableTextureFlags,
+		false,
+		CreateInfo,
+		OutTargetableTexture,
+		OutShaderResourceTexture,
+		NumSamples);
 #else
-
-			RHICreateTargetableShaderResource2D(EyeSizeX,
-				EyeSizeY,
-				PF_R8G8B8A8,
-				1,
-				TexCreate_None,
-				TexCreate_RenderTargetable,
-				false,
-				CreateInfo,
-				EyeInfos[EyeIndex].BufferedRTRHI,
-				EyeInfos[EyeIndex].BufferedSRVRHI);
+	const FRHITextureCreateDesc Desc =
+		FRHITextureCreateDesc::Create2D(TEXT("TiltFiveSceneRT"))
+		.SetExtent(SizeX, SizeY)
+		.SetFormat(PixelFormat)
+		.SetNumMips(NumMips)
+		.SetFlags(Flags | TargetableTextureFlags | ETextureCreateFlags::ShaderResource);
+	OutTargetableTexture = RHICreateTexture(Desc);
+	OutShaderResourceTexture = OutTargetableTexture;
 #endif
-		}
-	}
 
-	// Create the native buffer for rendering using the default handling, so return false here
-	return false;
+	return OutTargetableTexture.IsValid();
 }
 #endif
 
@@ -721,141 +1104,149 @@ bool FTiltFiveCustomPresent::NeedsNativePresent()
 
 bool FTiltFiveCustomPresent::Present(int32& InOutSyncInterval)
 {
-	//UE_LOG(LogTiltFive, Error, TEXT("Running Custom Present"));
-	// XXX: This currently passes, but is this always going to be called on the render thread?
-	check(IsInRenderingThread());
-	// XXX: Important note: Custom Present currently runs on the "RHI" thread, which, when using
-	// DirectX 11 is synonymous with the render thread. Unreal 5.0 forward supported DirectX 12
-	// by default. When this happens, we are no longer on the render thread, and are wholly on
-	// the RHI thread. We don't currently support DirectX 12, but once we do, we need to refactor
-	// this section to make sure the pose is accessible on the RHI thread specifically, separate
-	// from the render thread.
+	SCOPE_CYCLE_COUNTER(STAT_TiltFivePresent);
 
-	for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> HMD : GlassesList) {
-		if (!HMD->IsHMDEnabled() || !HMD->MaybeRelativeGlassesTransform_RenderThread.IsSet())
+	// This runs on the RHI thread when there is one, so it only works off the submit packets the render thread handed over
+	const ET5GraphicsAPI GraphicsAPI = GetGlassesGraphicsApi();
+
+	static const FName SubmitStatNames[] = {GET_STATFNAME(STAT_TiltFiveSubmitMs0),
+		GET_STATFNAME(STAT_TiltFiveSubmitMs1),
+		GET_STATFNAME(STAT_TiltFiveSubmitMs2),
+		GET_STATFNAME(STAT_TiltFiveSubmitMs3)};
+	static_assert(UE_ARRAY_COUNT(SubmitStatNames) == FTiltFiveGlassesRegistry::NumSlots, "One submit stat per pair of glasses");
+
+	// Initializing the graphics context and sending frames must happen on the thread that provided the graphics context, so every
+	// pair of glasses is submitted from here, one after another in device order
+	bool bAllContextsInitialized = true;
+	for (int32 DeviceId = 0; DeviceId < SubmitPackets_RHIThread.Num(); ++DeviceId)
+	{
+		FTiltFiveSubmitPacket& Packet = SubmitPackets_RHIThread[DeviceId];
+		if (!Packet.bValid)
 		{
 			continue;
 		}
 
-		FQuat GlassesOrientation = HMD->MaybeRelativeGlassesTransform_RenderThread->GetRotation();
-		FVector GlassesPosition = HMD->MaybeRelativeGlassesTransform_RenderThread->GetTranslation();
+		const FTiltFiveSubmitResult Result = SubmitPacket_RHIThread(Packet, GraphicsAPI);
+		Packet.bValid = false;
 
-		FT5FrameInfo FrameInfo;
+		if (!Result.bGraphicsContextInitialized)
+		{
+			UE_LOG(LogTiltFive, Error, TEXT("Failed to initialize graphics context"));
+			bAllContextsInitialized = false;
+			continue;
+		}
 
-		const float WorldToMetersScale = HMD->GetWorldToMetersScale();
+		SET_FLOAT_STAT_FName(SubmitStatNames[DeviceId], Result.SubmitSeconds * 1000.0);
 
-		float IPD_UWRLD = HMD->GetInterpupillaryDistance() * WorldToMetersScale;
+		UE_CLOG(Result.SendResult != T5_SUCCESS, LogTiltFive, Error, TEXT("Failed to send frame: %S"), t5GetResultMessage(Result.SendResult));
 
-		FTiltFiveHMD::ConvertPositionToHardware(
-			GlassesPosition - GlassesOrientation.GetRightVector() * IPD_UWRLD * 0.5f, FrameInfo.posLVC_GBD, WorldToMetersScale);
-		FTiltFiveHMD::ConvertPositionToHardware(
-			GlassesPosition + GlassesOrientation.GetRightVector() * IPD_UWRLD * 0.5f, FrameInfo.posRVC_GBD, WorldToMetersScale);
+		// The frame is on its way to the glasses, so this is where we learn how far ahead poses have to be predicted
+		if (Result.SendResult == T5_SUCCESS)
+		{
+			GlassesList[DeviceId]->UpdateLatencyEstimates(Result.SentTime, Packet.RenderThreadPoseTime, Packet.GameThreadPoseTime);
+		}
+	}
+	return bAllContextsInitialized;
+}
 
-		FTiltFiveHMD::ConvertRotationToHardware(GlassesOrientation, FrameInfo.rotToLVC_GBD);
-		FTiltFiveHMD::ConvertRotationToHardware(GlassesOrientation, FrameInfo.rotToRVC_GBD);
+FTiltFiveCustomPresent::FTiltFiveSubmitResult FTiltFiveCustomPresent::SubmitPacket_RHIThread(
+	const FTiltFiveSubmitPacket& Packet, ET5GraphicsAPI GraphicsAPI) const
+{
+	FTiltFiveSubmitResult Result;
 
-		FrameInfo.vci.startX_VCI = -FMath::Tan(HMD->FOV * (0.5f * PI / 180.0f));
-		FrameInfo.vci.startY_VCI = FrameInfo.vci.startX_VCI / HMD->WidthToHeight;
-		FrameInfo.vci.width_VCI = -2.0f * FrameInfo.vci.startX_VCI;
-		FrameInfo.vci.height_VCI = -2.0f * FrameInfo.vci.startY_VCI;
+	const TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe>& HMD = GlassesList[Packet.DeviceId];
 
-		FrameInfo.isUpsideDown = true;
-		FrameInfo.isSrgb = EnumHasAnyFlags(HMD->EyeInfos[0].BufferedSRVRHI->GetFlags(), TexCreate_SRGB) != 0;
-		FrameInfo.leftTexHandle = HMD->EyeInfos[0].BufferedSRVRHI->GetNativeResource();
-		FrameInfo.rightTexHandle = HMD->EyeInfos[1].BufferedSRVRHI->GetNativeResource();
-		FrameInfo.texWidth_PIX = HMD->EyeInfos[0].BufferedSRVRHI->GetSizeX();
-		FrameInfo.texHeight_PIX = HMD->EyeInfos[0].BufferedSRVRHI->GetSizeY();
+	// Initializing the graphics context and sending frames are group 3 calls, so they don't contend with pose sampling
+	FScopeLock GraphicsScopeLock(&(HMD->ExclusiveGroup3CriticalSection));
+	if (Packet.Glasses != HMD->GraphicsInitializedGlasses)
+	{
+		// Obtain a graphics context
+		void* GraphicsContext = nullptr;
+		T5_GraphicsContextGL GraphicsContextGL{};
+#if TILTFIVE_WITH_VULKAN
+		T5_GraphicsContextVulkan GraphicsContextVulkan{};
+#endif
 
-		if (HMD->CurrentExclusiveGlasses)
+		switch (GraphicsAPI)
 		{
-			FScopeLock ScopeLock(&(HMD->ExclusiveGroup1CriticalSection));
+		case kT5_GraphicsApi_D3D11:
+			GraphicsContext = GDynamicRHI->RHIGetNativeDevice();
+			break;
 
-			if (HMD->CurrentExclusiveGlasses != HMD->GraphicsInitializedGlasses)
+		case kT5_GraphicsApi_GL:
+			if (Packet.bUsesTextureArray)
 			{
-				// Obtain a graphics context
-				ET5GraphicsAPI GraphicsAPI{};
-				void* GraphicsContext{};
-				const FString RHIName = GDynamicRHI->GetName();
-
-				GraphicsAPI = kT5_GraphicsApi_None;
-				GraphicsContext = nullptr;
-				if (RHIName == TEXT("D3D11"))
-				{
-					GraphicsAPI = kT5_GraphicsApi_D3D11;
-					GraphicsContext = GDynamicRHI->RHIGetNativeDevice();
-				}
-				else if (RHIName == TEXT("OpenGL"))
-				{
-					GraphicsAPI = kT5_GraphicsApi_GL;
-				}
-				UE_LOG(LogTiltFive, Error, TEXT("Initializing Graphics Context"));
-				FT5Result Result = t5InitGlassesGraphicsContext(HMD->CurrentExclusiveGlasses, GraphicsAPI, GraphicsContext);
-				if (Result != T5_SUCCESS)
-				{
-					UE_LOG(LogTiltFive, Error, TEXT("Failed to initialize graphics context"));
-					return false;
-				}
-
-				HMD->GraphicsInitializedGlasses = HMD->CurrentExclusiveGlasses;
+				GraphicsContextGL.textureMode = kT5_GraphicsApi_GL_TextureMode_Array;
+				GraphicsContextGL.leftEyeArrayIndex = 0;
+				GraphicsContextGL.rightEyeArrayIndex = 1;
+				GraphicsContext = &GraphicsContextGL;
 			}
-			const FT5Result Result = t5SendFrameToGlasses(HMD->CurrentExclusiveGlasses, &FrameInfo);
+			break;
 
-			UE_CLOG(Result != T5_SUCCESS, LogTiltFive, Error, TEXT("Failed to send frame: %S"), t5GetResultMessage(Result));
+#if TILTFIVE_WITH_VULKAN
+		case kT5_GraphicsApi_Vulkan:
+		{
+			// The glasses share the engine's graphics queue, whose family also supports compute on every Vulkan device the
+			// engine runs on. Frames are submitted as VkImages, the eye textures stay on the GPU.
+			IVulkanDynamicRHI* VulkanRHI = GetIVulkanDynamicRHI();
+			VulkanHandles_RHIThread.Instance = VulkanRHI->RHIGetVkInstance();
+			VulkanHandles_RHIThread.PhysicalDevice = VulkanRHI->RHIGetVkPhysicalDevice();
+			VulkanHandles_RHIThread.Device = VulkanRHI->RHIGetVkDevice();
+			VulkanHandles_RHIThread.Queue = VulkanRHI->RHIGetGraphicsVkQueue();
+			GraphicsContextVulkan.instance = &VulkanHandles_RHIThread.Instance;
+			GraphicsContextVulkan.physicalDevice = &VulkanHandles_RHIThread.PhysicalDevice;
+			GraphicsContextVulkan.device = &VulkanHandles_RHIThread.Device;
+			GraphicsContextVulkan.queue = &VulkanHandles_RHIThread.Queue;
+			GraphicsContextVulkan.queueFamilyIndex = VulkanRHI->RHIGetGraphicsQueueFamilyIndex();
+			GraphicsContextVulkan.textureMode = kT5_GraphicsApi_Vulkan_TextureMode_Image;
+			GraphicsContext = &GraphicsContextVulkan;
+			break;
 		}
-	}
-	return true;
-}
+#endif
 
-//This needs to check all glasses to make sure they have textures assigned
-void FTiltFiveCustomPresent::UpdateViewport(const class FViewport& Viewport, class FRHIViewport* InViewportRHI)
-{
-	FXRRenderBridge::UpdateViewport(Viewport, InViewportRHI);
+		default:
+			break;
+		}
+		UE_LOG(LogTiltFive, Log, TEXT("Initializing graphics context for glasses %d"), Packet.DeviceId);
+		if (t5InitGlassesGraphicsContext(Packet.Glasses, GraphicsAPI, GraphicsContext) != T5_SUCCESS)
+		{
+			return Result;
+		}
 
-	if (GlassesList[0]->EyeInfos[0].BufferedRTRHI)
+		HMD->GraphicsInitializedGlasses = Packet.Glasses;
+		HMD->NotifyGraphicsInitialized_RenderThread();
+	}
+	Result.bGraphicsContextInitialized = true;
+
+	const T5_FrameInfo* FrameInfo = &Packet.FrameInfo;
+#if TILTFIVE_WITH_VULKAN
+	// Vulkan takes pointers to the VkImage handles, which only have to live until the frame is sent
+	T5_FrameInfo VulkanFrameInfo;
+	VkImage EyeImages[NumEyeRenderTargets] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+	if (GraphicsAPI == kT5_GraphicsApi_Vulkan)
 	{
-		return;
+		IVulkanDynamicRHI* VulkanRHI = GetIVulkanDynamicRHI();
+		VulkanFrameInfo = Packet.FrameInfo;
+		EyeImages[0] = VulkanRHI->RHIGetVkImage(Packet.Textures[0]);
+		VulkanFrameInfo.leftTexHandle = &EyeImages[0];
+		if (Packet.Textures[1])
+		{
+			EyeImages[1] = VulkanRHI->RHIGetVkImage(Packet.Textures[1]);
+			VulkanFrameInfo.rightTexHandle = &EyeImages[1];
+		}
+		FrameInfo = &VulkanFrameInfo;
 	}
-	const FIntPoint Size = GlassesList[0]->GetIdealRenderTargetSize();
+#endif
 
-	FRHIResourceCreateInfo CreateInfo{ TEXT("TiltFiveCreateInfo") };
-	const int32 EyeSizeX = Size.X / 2;
-	const int32 EyeSizeY = Size.Y;
-	GlassesList[0]->WidthToHeight = (float)EyeSizeX / (float)EyeSizeY;
+	const double SubmitStartTime = FPlatformTime::Seconds();
+	Result.SendResult = t5SendFrameToGlasses(Packet.Glasses, FrameInfo);
+	Result.SentTime = FPlatformTime::Seconds();
+	Result.SubmitSeconds = Result.SentTime - SubmitStartTime;
 
-#if UE_VERSION_NEWER_THAN(5, 2, 0)
-	FRHITextureCreateDesc Desc =
-		FRHITextureCreateDesc::Create2D(TEXT("TiltFiveCreateInfo"))
-		.SetExtent(EyeSizeX, EyeSizeY)
-		.SetFormat(PF_R8G8B8A8)
-		.SetFlags(ETextureCreateFlags::RenderTargetable | ETextureCreateFlags::ShaderResource);
-#endif
-	for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> HMD : GlassesList) {
-		for (int32 EyeIndex = 0; EyeIndex < NumEyeRenderTargets; ++EyeIndex)
-		{
-			FTiltFiveEyeInfo& EyeInfo = HMD->EyeInfos[EyeIndex];
-#if !UE_BUILD_SHIPPING
-			EyeInfo.DebugName = FString::Printf(TEXT("TiltFiveEyeRT%d"), EyeIndex);
-			CreateInfo.DebugName = *EyeInfo.DebugName;
-#endif
-			EyeInfo.SourceEyeRect = FIntRect(EyeSizeX * EyeIndex, (EyeSizeY * HMD->DeviceId), EyeSizeX * EyeIndex + EyeSizeX, (EyeSizeY * HMD->DeviceId) + EyeSizeY);
-			EyeInfo.DestEyeRect = FIntRect(0, 0, EyeSizeX, EyeSizeY);
+	return Result;
+}
 
-#if UE_VERSION_OLDER_THAN(5, 3, 0)
-			RHICreateTargetableShaderResource2D(EyeSizeX,
-				EyeSizeY,
-				PF_R8G8B8A8,
-				1,
-				TexCreate_None,
-				TexCreate_RenderTargetable,
-				false,
-				CreateInfo,
-				EyeInfo.BufferedRTRHI,
-				EyeInfo.BufferedSRVRHI);
-#else
-			FTexture2DRHIRef Texture = RHICreateTexture(Desc);
-			EyeInfo.BufferedRTRHI = Texture;
-			EyeInfo.BufferedSRVRHI = Texture;
-#endif
-		}
-	}
+void FTiltFiveCustomPresent::SetSubmitPackets_RHIThread(const FTiltFiveSubmitPackets& Packets)
+{
+	SubmitPackets_RHIThread = Packets;
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "TiltFiveTypes.h"
+
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+
+/**
+ * Base of the threads that talk to one pair of exclusive glasses in the background, e.g. the pose sampler.
+ *
+ * Owns the thread and its wake event, so all of them start and shut down the same way. The thread calls Tick in a loop until the
+ * worker is stopped.
+ */
+class FTiltFiveGlassesWorker : public FRunnable
+{
+public:
+	virtual ~FTiltFiveGlassesWorker() override;
+
+	/** Starts the worker thread. */
+	bool Start();
+
+	/**
+	 * Signals the worker thread to exit and waits for it. Must be called before the glasses are destroyed, and before the worker
+	 * is, since the thread calls into the derived class.
+	 */
+	void StopAndWait();
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	// /FRunnable
+
+protected:
+	FTiltFiveGlassesWorker(FT5GlassesPtr InGlasses, int32 InDeviceId, const TCHAR* InName, EThreadPriority InPriority);
+
+	/** Does one round of work on the worker thread. Returns how long to wait on the wake event before the next round. */
+	virtual uint32 Tick() = 0;
+
+	/** Called before the worker thread is created. */
+	virtual void OnStart() {}
+
+	/** Called once the worker thread has exited. */
+	virtual void OnStopped() {}
+
+	FT5GlassesPtr Glasses;
+	const int32 DeviceId;
+
+private:
+	const TCHAR* Name;
+	const EThreadPriority Priority;
+
+	FRunnableThread* Thread = nullptr;
+	FEvent* WakeEvent = nullptr;
+	std::atomic<bool> bStopRequested{false};
+};
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Queue.h"
 #include "HeadMountedDisplayBase.h"
 #include "IXRCamera.h"
 #include "Misc/EngineVersionComparison.h"
@@ -22,28 +23,234 @@
 #include "SceneViewExtension.h"
 
 #include "TiltFive.h"
+#include "TiltFiveGlassesRegistry.h"
+#include "TiltFiveParamWatcher.h"
+#include "HMD/TiltFiveHaptics.h"
+#include "HMD/TiltFivePosePredictor.h"
+#include "HMD/TiltFivePoseSampler.h"
+#include "HMD/TiltFiveWandStreamReader.h"
 
 #include <atomic>
 
 constexpr int32 NumEyeRenderTargets = 2;
 
+// Format of the textures sent to the glasses. Eyes are only copied out of scene render targets of a copy compatible format.
+constexpr EPixelFormat EyeTextureFormat = PF_R8G8B8A8;
+
+// Resolution of one eye, used until glasses reported their own through t5GetProjection
+constexpr int32 DefaultEyeSizeX = 1216;
+constexpr int32 DefaultEyeSizeY = 768;
+
 struct FTiltFiveEyeInfo
 {
 	FTexture2DRHIRef BufferedRTRHI;
 	FTexture2DRHIRef BufferedSRVRHI;
-	FIntRect SourceEyeRect;
-	FIntRect DestEyeRect;
 #if !UE_BUILD_SHIPPING
 	FString DebugName;
 #endif
 };
 
-struct FTiltFiveWorldState
+/**
+ * Where the eyes of each player are rendered in the shared scene render target. Only players with glasses get a row, packed from
+ * the top in player order, so the render target is only as tall as the number of connected players.
+ */
+struct FTiltFiveAtlasLayout
+{
+	FIntPoint EyeSize = FIntPoint(DefaultEyeSizeX, DefaultEyeSizeY);
+	int32 NumRows = 0;
+
+	// Row of each player, INDEX_NONE for players that aren't rendered
+	int32 PlayerRows[FTiltFiveGlassesRegistry::NumSlots];
+
+	FTiltFiveAtlasLayout()
+	{
+		for (int32& PlayerRow : PlayerRows)
+		{
+			PlayerRow = INDEX_NONE;
+		}
+	}
+
+	bool HasPlayer(int32 PlayerIndex) const { return PlayerRows[PlayerIndex] != INDEX_NONE; }
+
+	/** The player stereo views without a player index render for: the first one with glasses, or player 0 if nobody has any. */
+	static int32 FindDefaultViewPlayer(uint32 EnabledPlayerMask)
+	{
+		return EnabledPlayerMask != 0 ? FMath::CountTrailingZeros(EnabledPlayerMask) : 0;
+	}
+
+	/**
+	 * Gives every player in the mask a row, in player order. Without any players the default player still gets one, so there is
+	 * something to spectate.
+	 */
+	void Build(const FIntPoint& InEyeSize, uint32 EnabledPlayerMask, int32 DefaultViewPlayerIndex)
+	{
+		*this = FTiltFiveAtlasLayout();
+		EyeSize = InEyeSize;
+		for (int32 PlayerIndex = 0; PlayerIndex < FTiltFiveGlassesRegistry::NumSlots; ++PlayerIndex)
+		{
+			if (EnabledPlayerMask & (1u << PlayerIndex))
+			{
+				PlayerRows[PlayerIndex] = NumRows++;
+			}
+		}
+		if (NumRows == 0)
+		{
+			PlayerRows[DefaultViewPlayerIndex] = NumRows++;
+		}
+	}
+
+	/** Size of the whole scene render target. */
+	FIntPoint GetSize() const { return FIntPoint(EyeSize.X * NumEyeRenderTargets, EyeSize.Y * FMath::Max(NumRows, 1)); }
+
+	/** Rectangle of one eye of a player that has a row. */
+	FIntRect GetEyeRect(int32 PlayerIndex, int32 EyeIndex) const
+	{
+		const FIntPoint Min(EyeSize.X * EyeIndex, EyeSize.Y * FMath::Max(PlayerRows[PlayerIndex], 0));
+		return FIntRect(Min, Min + EyeSize);
+	}
+};
+
+/** Pose and velocities of a wand at some point in time, in unscaled Unreal coordinates. */
+struct FTiltFiveWandMotion
+{
+	FVector Position = FVector::ZeroVector;
+	FQuat Orientation = FQuat::Identity;
+
+	// Per second, the angular velocity as rotation axis scaled by radians per second
+	FVector LinearVelocity = FVector::ZeroVector;
+	FVector AngularVelocity = FVector::ZeroVector;
+};
+
+/** Projection of one pair of glasses. Both eyes share it, they only differ in their pose. */
+struct FTiltFiveProjection
+{
+	FMatrix ProjectionMatrix = FMatrix::Identity;
+
+	// The image rectangle of the virtual cameras in their normalized (z=1) image space, as sent to the glasses with every frame
+	float StartX_VCI = 0.0f;
+	float StartY_VCI = 0.0f;
+	float Width_VCI = 0.0f;
+	float Height_VCI = 0.0f;
+};
+
+/**
+ * Keeps the projection of a pair of glasses around until one of its inputs changes. Not thread safe, every thread that needs
+ * projections owns its own cache.
+ */
+class FTiltFiveProjectionCache
+{
+public:
+	const FTiltFiveProjection& Get(float FOV, const FIntPoint& EyeSize, float NearPlane);
+
+	/** Number of times the projection was recomputed. */
+	uint32 GetNumUpdates() const { return NumUpdates; }
+
+private:
+	uint32 NumUpdates = 0;
+	float CachedFOV = -1.0f;
+	FIntPoint CachedEyeSize = FIntPoint::ZeroValue;
+	float CachedNearPlane = -1.0f;
+
+	FTiltFiveProjection Projection;
+};
+
+/** What the game thread decided about one pair of glasses for a frame. */
+struct FTiltFiveFrameGlassesState
+{
+	bool bEnabled = false;
+
+	// The early pose of the glasses relative to the AR root, unset if no pose was available
+	TOptional<FTransform> MaybeRelativeGlassesTransform;
+	double PoseTime = 0.0;
+
+	float IPD = 0.064f;
+	float FOV = 70.0f;
+};
+
+/**
+ * Everything the render thread needs to know about a game frame. FTiltFiveXRBase owns a fixed set of these that it fills in turn
+ * and hands to the render thread by pointer, so no per-frame allocations or per-player render commands are needed.
+ */
+struct FTiltFiveFrameState
+{
+	// GFrameCounter of the game frame that filled this state
+	uint64 FrameNumber = 0;
+
+	// Unset if the world has no world settings, in which case the default scale is used
+	bool bHasWorldToMetersScale = false;
+	float WorldToMetersScale = 100.0f;
+
+	// Stereo views that don't say which player they belong to render for this player, the first one with glasses
+	int32 DefaultViewPlayerIndex = 0;
+
+	// Where each player's eyes are rendered this frame
+	FTiltFiveAtlasLayout Atlas;
+
+	FTiltFiveFrameGlassesState Glasses[FTiltFiveGlassesRegistry::NumSlots];
+};
+
+/**
+ * The fixed set of frame states the game thread fills in turn. The game thread may run a frame ahead of the render thread, so with
+ * three of them the one being filled is never in use.
+ */
+class FTiltFiveFrameStateRing
 {
-	float WorldToMetersScale;
+public:
+	static constexpr int32 NumFrameStates = 3;
+
+	/** Hands the game thread the next frame state to fill, with what the last frame filled into it about the glasses cleared. */
+	FTiltFiveFrameState& BeginFrame_GameThread(uint64 FrameNumber)
+	{
+		FTiltFiveFrameState& FrameState = FrameStates[NextIndex];
+		NextIndex = (NextIndex + 1) % NumFrameStates;
+
+		FrameState.FrameNumber = FrameNumber;
+		for (FTiltFiveFrameGlassesState& GlassesState : FrameState.Glasses)
+		{
+			GlassesState.bEnabled = false;
+			GlassesState.MaybeRelativeGlassesTransform.Reset();
+		}
+		return FrameState;
+	}
+
+private:
+	FTiltFiveFrameState FrameStates[NumFrameStates];
+	int32 NextIndex = 0;
 };
 
-typedef TSharedPtr<FTiltFiveWorldState, ESPMode::ThreadSafe> FTiltFiveWorldStatePtr;
+/**
+ * Connection state of one pair of glasses. The states are traversed in order while connecting; any failure goes back to
+ * Disconnected, and losing the connection to exclusive glasses goes through Lost while the glasses are torn down.
+ */
+enum class ETiltFiveGlassesState : uint8
+{
+	// No glasses assigned to this player
+	Disconnected,
+	// Glasses for this player are listed by the service
+	Discovered,
+	// A handle to the glasses was created
+	Created,
+	// The glasses were reserved for this application
+	Reserved,
+	// The glasses are awake and ready for exclusive use
+	Ready,
+	// The glasses are published to the game and render threads and are being tracked
+	Exclusive,
+	// The render thread initialized the graphics context and is sending frames
+	GraphicsReady,
+	// The connection was lost and the glasses are being released
+	Lost,
+};
+
+struct FTiltFiveGlassesStateTransition
+{
+	ETiltFiveGlassesState OldState;
+	ETiltFiveGlassesState NewState;
+};
+
+/** Broadcast on the game thread for every connection state transition of a pair of glasses, with DeviceId, OldState, NewState */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(
+	FTiltFiveGlassesStateChanged, int32, ETiltFiveGlassesState, ETiltFiveGlassesState);
 
 /**
  * Tilt Five Head Mounted Display Interface Implementation
@@ -53,10 +260,28 @@ class TILTFIVE_API FTiltFiveHMD : public IHeadMountedDisplay,
 								  public TSharedFromThis<FTiltFiveHMD, ESPMode::ThreadSafe>
 {
 public:
-	FTiltFiveHMD(IXRTrackingSystem *base, int32 deviceId);
+	FTiltFiveHMD(IXRTrackingSystem *base, FTiltFiveGlassesRegistry& glassesRegistry, FTiltFiveParamWatcher& paramWatcher, int32 deviceId);
 	virtual ~FTiltFiveHMD() override;
 
-	void ConditionalInitializeGlasses();
+	/**
+	 * Advances the connection state machine by one step. Only called from the connection thread, never blocks on anything but
+	 * the service calls of the current step.
+	 */
+	void TickConnection_ConnectionThread(bool bAllowNewConnection);
+
+	/** Returns the next state transition that hasn't been applied on the game thread yet. */
+	bool DequeueStateTransition(FTiltFiveGlassesStateTransition& OutTransition);
+
+	/** Publishes or retracts the exclusive glasses for the game and render threads according to a new state. */
+	void ApplyStateTransition_GameThread(ETiltFiveGlassesState NewState);
+
+	/** Called once the graphics context for the exclusive glasses was initialized. */
+	void NotifyGraphicsInitialized_RenderThread();
+
+	ETiltFiveGlassesState GetGlassesState() const
+	{
+		return GlassesState;
+	}
 
 	virtual class IHeadMountedDisplay* GetHMDDevice();
 	virtual FName GetHMDName() const override;
@@ -141,24 +366,38 @@ public:
 
 	const int32 DeviceId;
 
-	// Critical section for the exclusive groups inside the tilt five API
+	// Critical section for the exclusive groups inside the tilt five API. The group 3 (graphics) lock is also held while the
+	// exclusive glasses get destroyed, so a frame is never sent to a dead handle. When both are needed, group 3 is taken first.
 	mutable FCriticalSection ExclusiveGroup1CriticalSection;
 	mutable FCriticalSection ExclusiveGroup2CriticalSection;
+	mutable FCriticalSection ExclusiveGroup3CriticalSection;
 
 	FRotator DeltaControlRotation;
 	FQuat DeltaControlOrientation;
 	
-	// Render thread cached glasses pose.
+	// Render thread cached glasses pose, predicted to the expected display time of the frame being rendered.
 	bool CachedGlassesPoseIsValid_RenderThread = false;
 	FQuat CachedGlassesOrientation_RenderThread;
 	FVector CachedGlassesPosition_RenderThread;
 	FT5GameboardType CachedGameboardType_RenderThread = FT5GameboardType::kT5_GameboardType_None;
+	// FPlatformTime::Seconds() when the render thread pose was predicted.
+	double CachedGlassesPoseTime_RenderThread = 0.0;
+	// FPlatformTime::Seconds() when the game thread pose of the frame being rendered was predicted.
+	double GameThreadPoseTime_RenderThread = 0.0;
 
-	// Game thread cached glasses pose.
+	// Game thread cached glasses pose, predicted to the expected display time of the frame being simulated.
 	bool CachedGlassesPoseIsValid_GameThread = false;
 	FQuat CachedGlassesOrientation_GameThread;
 	FVector CachedGlassesPosition_GameThread;
 	FT5GameboardType CachedGameboardType_GameThread = FT5GameboardType::kT5_GameboardType_None;
+	double CachedGlassesPoseTime_GameThread = 0.0;
+
+	// How the poses of these glasses are predicted, defaults to the project setting
+	std::atomic<ETiltFivePosePredictionMode> PosePredictionMode;
+
+	// Smoothed time from predicting a pose on the game or render thread until the frame using it is visible, measured in Present
+	std::atomic<float> EstimatedGameThreadLatencySeconds{0.0f};
+	std::atomic<float> EstimatedRenderThreadLatencySeconds{0.0f};
 
 	// The UWRLD pose of the glasses relative to its parent (i.e. the AR root) that is being used to render the current frame. This
 	// gets set to an 'early' pose by OnStartGameFrame and may get updated by OnLateUpdateApplied_RenderThread if a late update is
@@ -166,8 +405,6 @@ public:
 	TOptional<FTransform> MaybeRelativeGlassesTransform_RenderThread;
 	std::atomic<float> CachedTiltFiveIPD = 0.064f;
 
-	mutable bool bVersionCompatible;
-
 #if UE_VERSION_OLDER_THAN(4, 26, 0)
 	virtual void UpdateSplashScreen() override;
 #endif
@@ -175,30 +412,112 @@ public:
 	FT5GlassesPtr GetCurrentExclusiveGlasses() const;
 	FT5GameboardType GetCurrentGameboardType() const;
 
+	/** Projection of these glasses as seen by the calling (game or render) thread. */
+	const FTiltFiveProjection& GetProjection() const;
+
+	/** Resolution of one eye as reported by t5GetProjection. Returns false if the glasses were never readied. */
+	bool GetNativeEyeSize(FIntPoint& OutEyeSize) const;
+
 	void UpdateCachedGlassesPose_RenderThread();
 	void UpdateCachedGlassesPose_GameThread();
 
+	/**
+	 * Newest pose of the given wand straight from the wand stream, predicted as far ahead as the glasses pose of the frame being
+	 * rendered. Unscaled Unreal coordinates, like the wand poses of the input device. Returns false if there is no pose.
+	 */
+	bool PredictWandPose_RenderThread(FT5WandHandle WandHandle, FQuat& OutOrientation, FVector& OutPosition);
+
+	/**
+	 * Pose and velocities of the given wand at TimeSeconds (FPlatformTime::Seconds() based), interpolated from its pose history or
+	 * extrapolated a little past its newest pose. Safe to call from any thread. Returns false if there is no pose history.
+	 */
+	bool SampleWandMotion(FT5WandHandle WandHandle, double TimeSeconds, FTiltFiveWandMotion& OutMotion) const;
+
+	// Wand stream events of the exclusive glasses, written by WandStreamReader and drained by the input device on the game thread
+	FTiltFiveWandEventQueue WandEventQueue;
+
+	// Haptic impulses for the wands of the exclusive glasses, requested from any thread and sent by HapticsSender
+	FTiltFiveHapticsQueue HapticsQueue;
+
+	void UpdateLatencyEstimates(double FrameSentTime, double RenderThreadPoseTime, double GameThreadPoseTime);
+
 	FTiltFiveEyeInfo EyeInfos[2];
+
+	// Both eyes as the two slices of one texture, used instead of EyeInfos when submitting texture arrays to OpenGL glasses
+	FTextureRHIRef EyeTextureArray;
 	float FOV = 70.0f;
-	float WidthToHeight = 1.0f;
+
+	// Set once anything called OverrideFOV, after which the native field of view of the glasses is no longer applied
+	bool bFOVOverridden = false;
 
 	float GNearClippingPlane = 0.0f;
 
 	APawn *controlledPawn;
 
-	FT5GlassesPtr CurrentReservedGlasses = nullptr;
+	// The exclusive glasses as seen by the game thread. Only set while the glasses are in the Exclusive or GraphicsReady state.
 	FT5GlassesPtr CurrentExclusiveGlasses = nullptr;
+	// The exclusive glasses as seen by the render thread, follows CurrentExclusiveGlasses through render commands
+	FT5GlassesPtr ExclusiveGlasses_RenderThread = nullptr;
+	// The glasses whose graphics context was initialized, only touched by Present on the RHI thread
 	FT5GlassesPtr GraphicsInitializedGlasses = nullptr;
+	// The exclusive glasses the render thread last picked a way of submitting for, and whether that is EyeTextureArray
+	FT5GlassesPtr TextureModeGlasses_RenderThread = nullptr;
+	bool bUseTextureArray_RenderThread = false;
 
-	FTiltFiveWorldStatePtr CurrentWorldState;
-	FTiltFiveWorldStatePtr RenderThreadWorldState;
+	// The frame state of the frame currently being processed by the game and render thread, owned by FTiltFiveXRBase
+	const FTiltFiveFrameState* FrameState_GameThread = nullptr;
+	const FTiltFiveFrameState* FrameState_RenderThread = nullptr;
 
 private:
+	FTiltFiveGlassesRegistry& GlassesRegistry;
+	FTiltFiveParamWatcher& ParamWatcher;
+
 	FLateUpdateManager LateUpdate;
 	bool bUseImplicitHMDPosition;
 	mutable bool bCurrentFrameIsStereoRendering;
 
 	FT5GameboardType CurrentGameboardType = FT5GameboardType::kT5_GameboardType_None;
 
-	FT5GlassesPtr RetrieveGlasses() const;
+	// Latest poses of the exclusive glasses, written by PoseSampler and read without locking by the game and render threads
+	FTiltFivePoseRing PoseRing;
+	TUniquePtr<FTiltFivePoseSampler> PoseSampler;
+
+	// Latest wand poses of the exclusive glasses, written by WandStreamReader and read without locking by the render thread
+	FTiltFiveWandPoseRings WandPoseRings;
+	TUniquePtr<FTiltFiveWandStreamReader> WandStreamReader;
+
+	TUniquePtr<FTiltFiveHapticsSender> HapticsSender;
+
+	FTiltFivePosePredictor WandPosePredictors_RenderThread[FTiltFiveWandPoseRings::MaxWands];
+	// The wand each predictor last predicted, its filter state is dropped when the ring changes hands
+	int32 WandPosePredictorHandles_RenderThread[FTiltFiveWandPoseRings::MaxWands] = {INDEX_NONE, INDEX_NONE};
+
+	FTiltFivePosePredictor PosePredictor_GameThread;
+	FTiltFivePosePredictor PosePredictor_RenderThread;
+
+	mutable FTiltFiveProjectionCache ProjectionCache_GameThread;
+	mutable FTiltFiveProjectionCache ProjectionCache_RenderThread;
+
+	bool TransitionGlassesState(ETiltFiveGlassesState FromState, ETiltFiveGlassesState ToState);
+	void ReleaseConnectionGlasses();
+	void UpdateParams_ConnectionThread(bool bReadAll);
+	void QueryNativeProjection_ConnectionThread();
+	void StartWandStream_ConnectionThread();
+
+	std::atomic<ETiltFiveGlassesState> GlassesState{ETiltFiveGlassesState::Disconnected};
+	TQueue<FTiltFiveGlassesStateTransition, EQueueMode::Mpsc> StateTransitions;
+
+	// Connection thread state: the glasses handle owned by the state machine and the progress on connecting it
+	FT5GlassesPtr ConnectionGlasses = nullptr;
+	FTiltFiveGlassesIdentifier ConnectionGlassesIdentifier;
+	int32 EnsureReadyAttempts = 0;
+	double LastConnectionCheckTime = 0.0;
+
+	// Set by the render thread once it no longer uses the glasses, so the connection thread can destroy them
+	std::atomic<bool> bReleasedByRenderThread{false};
+
+	// What t5GetProjection reported when the glasses were last readied, zero until then. The eye size is packed as
+	// (Width << 16) | Height so both halves are always seen together.
+	std::atomic<uint32> NativeEyeSize{0};
+	std::atomic<float> NativeHorizontalFOV{0.0f};
 };
@@ -15,6 +15,8 @@
 #pragma once
 
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "TiltFiveSettings.h"
+#include "TiltFiveSpectatorLayout.h"
 
 #include "TiltFiveHMDBlueprintLibrary.generated.h"
 
@@ -53,4 +55,24 @@ class TILTFIVE_API UTiltFiveHMDBlueprintLibrary : public UBlueprintFunctionLibra
 
 	UFUNCTION(BlueprintCallable, Category = "Tilt Five|HMD")
 	bool IsTiltFiveUiRequestingAttention();
+
+public:
+	// Shows several players on the spectator screen at once, as a grid or picture in picture
+	UFUNCTION(BlueprintCallable, Category = "Tilt Five|HMD")
+	static void SetSpectatorLayout(const FTiltFiveSpectatorLayout& Layout);
+
+	// Overrides how the pose of the given player's glasses is predicted
+	UFUNCTION(BlueprintCallable, Category = "Tilt Five|HMD")
+	static void SetPosePredictionMode(int32 playerIndex, ETiltFivePosePredictionMode Mode);
+
+	UFUNCTION(BlueprintPure, Category = "Tilt Five|HMD")
+	static ETiltFivePosePredictionMode GetPosePredictionMode(int32 playerIndex);
+
+	// Version of the Tilt Five service, empty until the service is running
+	UFUNCTION(BlueprintPure, Category = "Tilt Five|HMD")
+	static FString GetServiceVersion();
+
+	// User-facing name of the given player's glasses, empty if the player has no glasses
+	UFUNCTION(BlueprintPure, Category = "Tilt Five|HMD")
+	static FString GetGlassesFriendlyName(int32 playerIndex);
 };
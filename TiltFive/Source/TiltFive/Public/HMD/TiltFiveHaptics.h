@@ -0,0 +1,119 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HMD/TiltFiveGlassesWorker.h"
+#include "TiltFiveTypes.h"
+
+class FEvent;
+
+/** A haptic impulse for one wand, to be played until EndSeconds (FPlatformTime::Seconds() based). */
+struct FTiltFiveHapticImpulse
+{
+	FT5WandHandle Wand;
+	float Amplitude;
+	double EndSeconds;
+};
+
+/**
+ * Haptic impulses requested for the wands of one pair of glasses, waiting for the haptics sender. Requests for a wand that still
+ * has an impulse waiting are merged into it, so requesting impulses never blocks on the service, however often it happens.
+ *
+ * Thread safe. Outlives the sender, so requests can be made whether or not the glasses are currently connected.
+ */
+class TILTFIVE_API FTiltFiveHapticsQueue
+{
+public:
+	static constexpr int32 MaxWands = 2;
+
+	// The service doesn't accept impulses longer than this
+	static constexpr uint32 MaxDurationMilliseconds = 320;
+
+	FTiltFiveHapticsQueue();
+	~FTiltFiveHapticsQueue();
+	FTiltFiveHapticsQueue(const FTiltFiveHapticsQueue&) = delete;
+	FTiltFiveHapticsQueue& operator=(const FTiltFiveHapticsQueue&) = delete;
+
+	/** Requests an impulse with the given amplitude (0 to 1) starting now. */
+	void Request(FT5WandHandle Wand, float Amplitude, uint32 DurationMilliseconds);
+
+	/** Moves all waiting impulses to OutImpulses, returns their number. */
+	int32 TakeAll(FTiltFiveHapticImpulse (&OutImpulses)[MaxWands]);
+
+	/** Forgets all waiting impulses, e.g. because the glasses went away. */
+	void Clear();
+
+	/** Blocks until impulses were requested, Wake was called or the timeout passed. */
+	void Wait(uint32 WaitMilliseconds);
+	void Wake();
+
+private:
+	FCriticalSection CriticalSection;
+	FTiltFiveHapticImpulse Waiting[MaxWands];
+	int32 NumWaiting = 0;
+
+	FEvent* RequestEvent = nullptr;
+};
+
+/**
+ * Sends the impulses requested through a haptics queue to the wands of one pair of exclusive glasses on a dedicated thread.
+ *
+ * This is the only place t5SendImpulse is called from. Impulses already covered by the one a wand is playing are merged into it,
+ * and every wand is sent at most one impulse per MinSendIntervalSeconds, so the service sees a bounded rate of calls.
+ */
+class FTiltFiveHapticsSender : public FTiltFiveGlassesWorker
+{
+public:
+	FTiltFiveHapticsSender(FT5GlassesPtr InGlasses, FCriticalSection& InExclusiveGroup1CriticalSection,
+		FTiltFiveHapticsQueue& InQueue, int32 InDeviceId);
+
+	// FRunnable
+	virtual void Stop() override;
+	// /FRunnable
+
+protected:
+	// FTiltFiveGlassesWorker
+	virtual uint32 Tick() override;
+	virtual void OnStart() override;
+	// /FTiltFiveGlassesWorker
+
+private:
+	// Impulse state of a single wand, only touched by the sender thread
+	struct FWandState
+	{
+		FT5WandHandle Wand = 0;
+		bool bInUse = false;
+
+		// The impulse the wand was last sent
+		float ActiveAmplitude = 0.0f;
+		double ActiveEndSeconds = 0.0;
+		double LastSentSeconds = 0.0;
+
+		// An impulse held back by the rate limit
+		bool bHasPending = false;
+		FTiltFiveHapticImpulse Pending;
+	};
+
+	FWandState& FindOrAddWand(FT5WandHandle Wand);
+
+	/** Sends the pending impulse of the wand if due. Returns when it should be looked at again, 0 if it has nothing pending. */
+	double SendPending(FWandState& WandState, double NowSeconds);
+
+	FCriticalSection& ExclusiveGroup1CriticalSection;
+	FTiltFiveHapticsQueue& Queue;
+
+	FWandState WandStates[FTiltFiveHapticsQueue::MaxWands];
+};
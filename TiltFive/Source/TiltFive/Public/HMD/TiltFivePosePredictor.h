@@ -0,0 +1,76 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HMD/TiltFivePoseSampler.h"
+#include "TiltFiveSettings.h"
+
+/**
+ * Extrapolates glasses poses from their recent history to the time the frame rendered with them is expected to be visible.
+ *
+ * All math happens on the raw hardware (gameboard space, meters) poses, so predicted poses can be converted with the usual
+ * FTiltFiveHMD helpers. A predictor keeps filter state between calls and is not thread safe; every thread that needs predicted
+ * poses owns its own predictor.
+ */
+class TILTFIVE_API FTiltFivePosePredictor
+{
+public:
+	// Number of samples considered when estimating velocities
+	static constexpr int32 MaxHistory = 8;
+
+	// Never extrapolate further than this, mispredictions grow quickly with the horizon
+	static constexpr double MaxHorizonSeconds = 0.05;
+
+	/** Forgets any filter state, e.g. after the glasses reconnected. */
+	void Reset();
+
+	/**
+	 * Predicts the pose HorizonSeconds after the newest of the given samples.
+	 *
+	 * Samples are ordered newest first and must all be valid.
+	 */
+	bool Predict(ETiltFivePosePredictionMode Mode,
+		const FTiltFivePoseSample* Samples,
+		int32 NumSamples,
+		double HorizonSeconds,
+		FT5GlassesPose& OutPose);
+
+	/**
+	 * Predicts the pose LatencySeconds from now, using the most recent valid history in the pose ring.
+	 *
+	 * Returns false if the ring has no valid pose.
+	 */
+	bool Predict(ETiltFivePosePredictionMode Mode, const FTiltFivePoseRing& PoseRing, double LatencySeconds, FT5GlassesPose& OutPose);
+
+	/**
+	 * Copies the most recent run of valid samples out of the pose ring, newest first, up to MaxSamples of them.
+	 *
+	 * Returns the number of samples copied.
+	 */
+	static int32 ReadHistory(const FTiltFivePoseRing& PoseRing, FTiltFivePoseSample* OutSamples, int32 MaxSamples);
+
+private:
+	void PredictConstantVelocity(const FTiltFivePoseSample* Samples, int32 NumSamples, double HorizonSeconds, FT5GlassesPose& OutPose) const;
+	void PredictFiltered(const FTiltFivePoseSample* Samples, int32 NumSamples, double HorizonSeconds, FT5GlassesPose& OutPose);
+
+	// Alpha-beta filter state, in hardware space
+	bool bFilterInitialized = false;
+	uint64 FilterTimestampNanos = 0;
+	FVector FilterPosition = FVector::ZeroVector;
+	FVector FilterVelocity = FVector::ZeroVector;
+	FQuat FilterRotation = FQuat::Identity;
+	FVector FilterAngularVelocity = FVector::ZeroVector;
+};
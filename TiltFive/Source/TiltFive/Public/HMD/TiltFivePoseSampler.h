@@ -0,0 +1,64 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HMD/TiltFiveGlassesWorker.h"
+#include "TiltFiveRingBuffer.h"
+#include "TiltFiveTypes.h"
+
+/** A single glasses pose as reported by the service, together with the time it was sampled on our side. */
+struct FTiltFivePoseSample
+{
+	FT5GlassesPose Pose;
+
+	// False if the service had no pose for the glasses at the time of sampling, e.g. because no gameboard was visible.
+	bool bValid;
+
+	// FPlatformTime::Cycles64() at the time the service returned the pose.
+	uint64 HostCycles;
+};
+
+/** Number of pose samples each pair of glasses keeps around. At the sampling rate this is a little over 100ms of history. */
+constexpr uint32 TiltFivePoseRingCapacity = 64;
+
+typedef TTiltFiveSeqlockRing<FTiltFivePoseSample, TiltFivePoseRingCapacity> FTiltFivePoseRing;
+
+/**
+ * Polls the pose of one pair of exclusive glasses on a dedicated thread and publishes every new pose into a pose ring.
+ *
+ * This is the only place t5GetGlassesPose is called from, so the game and render threads never have to take the exclusive
+ * group 1 lock (or wait on the service) to get a pose, they just read the latest sample from the ring.
+ */
+class FTiltFivePoseSampler : public FTiltFiveGlassesWorker
+{
+public:
+	FTiltFivePoseSampler(FT5GlassesPtr InGlasses, FCriticalSection& InExclusiveGroup1CriticalSection, FTiltFivePoseRing& InPoseRing,
+		int32 InDeviceId);
+
+protected:
+	// FTiltFiveGlassesWorker
+	virtual uint32 Tick() override;
+	virtual void OnStopped() override;
+	// /FTiltFiveGlassesWorker
+
+private:
+	FCriticalSection& ExclusiveGroup1CriticalSection;
+	FTiltFivePoseRing& PoseRing;
+
+	// Producer side state, only touched by the sampling thread
+	bool bLastPushedValid = false;
+	uint64 LastPushedTimestampNanos = 0;
+};
@@ -0,0 +1,105 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HMD/TiltFiveGlassesWorker.h"
+#include "HMD/TiltFivePoseSampler.h"
+#include "TiltFiveRingBuffer.h"
+#include "TiltFiveTypes.h"
+
+#include <atomic>
+
+/** A wand stream event as read from the service, together with the time it was read on our side. */
+struct FTiltFiveWandStreamEvent
+{
+	FT5WandStreamEvent Event;
+
+	// FPlatformTime::Cycles64() at the time the service returned the event.
+	uint64 HostCycles;
+};
+
+/** Number of wand events that can be queued between two game frames. Wands report at a few hundred Hz, this covers > 100ms. */
+constexpr uint32 TiltFiveWandEventQueueCapacity = 256;
+
+typedef TTiltFiveSpscQueue<FTiltFiveWandStreamEvent, TiltFiveWandEventQueueCapacity> FTiltFiveWandEventQueue;
+
+/**
+ * Pose history of the wands of one pair of glasses, in the same format as the glasses poses so they can be predicted the same way.
+ * The grip position and wand rotation take the place of the glasses pose.
+ */
+struct FTiltFiveWandPoseRings
+{
+	static constexpr int32 MaxWands = 2;
+
+	FTiltFiveWandPoseRings()
+	{
+		for (std::atomic<int32>& WandHandle : WandHandles)
+		{
+			WandHandle = INDEX_NONE;
+		}
+	}
+
+	/** Returns the ring holding the poses of the given wand, INDEX_NONE if there is none. */
+	int32 FindRing(FT5WandHandle WandHandle) const
+	{
+		for (int32 RingIndex = 0; RingIndex < MaxWands; ++RingIndex)
+		{
+			if (WandHandles[RingIndex].load(std::memory_order_acquire) == WandHandle)
+			{
+				return RingIndex;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	// The wand each ring belongs to, INDEX_NONE while unused. Only assigned by the reader thread, which frees a ring again when its
+	// wand disconnects. Readers check the handle again after reading, in case the ring changed hands meanwhile.
+	std::atomic<int32> WandHandles[MaxWands];
+	FTiltFivePoseRing Rings[MaxWands];
+};
+
+/**
+ * Reads the wand stream of one pair of exclusive glasses on a dedicated thread and queues every event for the game thread.
+ *
+ * This is the only place t5ReadWandStreamForGlasses is called from. The thread blocks on the stream, so events are picked up as
+ * soon as the service has them, and the game thread only drains whatever was queued since its last frame. Wand poses are also
+ * published into pose rings, so the render thread can use the newest pose without waiting for the game thread.
+ */
+class FTiltFiveWandStreamReader : public FTiltFiveGlassesWorker
+{
+public:
+	/** The wand stream of the glasses has to be configured before the reader is started. */
+	FTiltFiveWandStreamReader(FT5GlassesPtr InGlasses, FCriticalSection& InExclusiveGroup2CriticalSection,
+		FTiltFiveWandEventQueue& InEventQueue, FTiltFiveWandPoseRings& InPoseRings, int32 InDeviceId);
+
+protected:
+	// FTiltFiveGlassesWorker
+	virtual uint32 Tick() override;
+	virtual void OnStart() override;
+	virtual void OnStopped() override;
+	// /FTiltFiveGlassesWorker
+
+private:
+	void PublishPose(const FTiltFiveWandStreamEvent& StreamEvent);
+	void ReleaseRing(int32 RingIndex, uint64 HostCycles);
+
+	FCriticalSection& ExclusiveGroup2CriticalSection;
+	FTiltFiveWandEventQueue& EventQueue;
+	FTiltFiveWandPoseRings& PoseRings;
+
+	// Reader thread state
+	uint32 NumDroppedEvents = 0;
+};
@@ -0,0 +1,96 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/EngineVersionComparison.h"
+#include "RHI.h"
+#include "RHIResources.h"
+#if UE_VERSION_NEWER_THAN(4, 25, 4)
+#include "ScreenRendering.h"
+#include "Shader.h"
+#endif
+
+class FRHICommandListImmediate;
+class IRendererModule;
+
+/** A rectangle of a texture to be drawn into a rectangle of another texture. */
+struct FTiltFiveTextureCopy
+{
+	FRHITexture2D* Texture = nullptr;
+
+	// Empty copies the whole texture
+	FIntRect SrcRect;
+	FIntRect DstRect;
+
+	// False blends the source over the target by its alpha
+	bool bNoAlpha = true;
+};
+
+#if UE_VERSION_NEWER_THAN(4, 25, 4)
+
+// The sRGB source pixel shader only exists in newer engines, older ones read sRGB sources like any other
+#if UE_VERSION_NEWER_THAN(5, 1, 0)
+typedef FScreenPSsRGBSource FTiltFiveScreenPSsRGBSource;
+#else
+typedef FScreenPS FTiltFiveScreenPSsRGBSource;
+#endif
+
+/**
+ * Draws any number of texture copies into one target within a single render pass, one draw per copy.
+ *
+ * Pipeline state initializers are built once per target format and kind of copy (sRGB source or not, blended or not), samplers and
+ * shaders are only looked up once, and pipeline state is only set again when a copy needs a different one than the previous copy.
+ * Render thread only. Engines without the transition API copy one by one through CopyTexture_RenderThread instead.
+ */
+class FTiltFiveCopyPass
+{
+public:
+	void Draw_RenderThread(FRHICommandListImmediate& RHICmdList,
+		IRendererModule& RendererModule,
+		FRHITexture2D* TargetTexture,
+		TArrayView<const FTiltFiveTextureCopy> Copies,
+		bool bClearBlack);
+
+private:
+	enum EPipelineFlags
+	{
+		Pipeline_SrgbSource = 1 << 0,
+		Pipeline_Blended = 1 << 1,
+		Pipeline_Num = 1 << 2
+	};
+
+	// Pipelines for all kinds of copies into targets of one format
+	struct FPipelineSet
+	{
+		EPixelFormat TargetFormat;
+		ETextureCreateFlags TargetSrgbFlag;
+		FGraphicsPipelineStateInitializer Pipelines[Pipeline_Num];
+	};
+
+	void UpdateShaders();
+	const FPipelineSet& FindOrAddPipelines(FRHICommandListImmediate& RHICmdList, FRHITexture2D* TargetTexture);
+
+	TArray<FPipelineSet, TInlineAllocator<4>> PipelineSets;
+
+	const FGlobalShaderMap* CachedShaderMap = nullptr;
+	TShaderRef<FScreenVS> VertexShader;
+	TShaderRef<FScreenPS> PixelShader;
+	TShaderRef<FTiltFiveScreenPSsRGBSource> PixelShaderSrgbSource;
+
+	FRHISamplerState* PointSampler = nullptr;
+	FRHISamplerState* BilinearSampler = nullptr;
+};
+#endif
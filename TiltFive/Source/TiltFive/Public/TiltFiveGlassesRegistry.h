@@ -0,0 +1,115 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include "TiltFiveTypes.h"
+
+#include <atomic>
+
+/** Identifier of a pair of glasses as listed by the service, stored inline so it can be copied around without allocating. */
+struct FTiltFiveGlassesIdentifier
+{
+	ANSICHAR Id[T5_MAX_STRING_PARAM_LEN] = {};
+
+	bool IsEmpty() const
+	{
+		return Id[0] == '\0';
+	}
+
+	bool Equals(const ANSICHAR* Other) const
+	{
+		return FCStringAnsi::Strcmp(Id, Other) == 0;
+	}
+};
+
+/**
+ * Single source of truth for which glasses the service knows about and which player slot they belong to.
+ *
+ * The glasses are listed once per refresh for all players, and every listed pair of glasses is assigned the lowest free slot.
+ * It keeps that slot for as long as it stays listed, so players don't swap glasses when others come and go. Glasses that can't
+ * be reserved give their slot up and sit out a growing cool-down, so they don't keep spare glasses from being used.
+ */
+class TILTFIVE_API FTiltFiveGlassesRegistry
+{
+public:
+	static constexpr int32 NumSlots = 4;
+
+	// We list a few more glasses than we have slots, so glasses that are listed first but used by another application don't
+	// overflow the buffer and hide the rest
+	static constexpr int32 MaxListedGlasses = NumSlots * 2;
+
+	/**
+	 * Lists the glasses and updates the slot assignment, at most once per refresh interval. Only called from the connection
+	 * thread, which is what keeps t5ListGlasses from being called concurrently.
+	 */
+	void Refresh_ConnectionThread();
+
+	/** Copies the identifier of the glasses assigned to the given slot. Returns false if the slot is free. */
+	bool GetSlotIdentifier(int32 Slot, FTiltFiveGlassesIdentifier& OutIdentifier) const;
+
+	/** Lock-free check whether any glasses are assigned to the given slot. */
+	bool IsSlotOccupied(int32 Slot) const
+	{
+		return (OccupiedSlotMask.load(std::memory_order_relaxed) & (1u << Slot)) != 0;
+	}
+
+	/**
+	 * Frees the slot of glasses that couldn't be used, e.g. because another application reserved them, and keeps them from
+	 * getting a slot again until their cool-down ran out. The cool-down doubles every time the same glasses fail again.
+	 */
+	void ReportGlassesUnavailable_ConnectionThread(int32 Slot, const FTiltFiveGlassesIdentifier& Identifier);
+
+	/** Clears the cool-down of glasses that were reserved, so a later failure starts backing off from the beginning again. */
+	void ReportGlassesReserved_ConnectionThread(const FTiltFiveGlassesIdentifier& Identifier);
+
+	/** Number of glasses listed by the last successful refresh, including those that didn't get a slot. */
+	int32 GetNumListedGlasses() const
+	{
+		return NumListedGlasses.load(std::memory_order_relaxed);
+	}
+
+	/** Records the outcome of a service call, so an incompatible service is noticed whichever call runs into it. */
+	void ReportServiceResult(FT5Result Result);
+
+	bool IsVersionCompatible() const
+	{
+		return bVersionCompatible;
+	}
+
+private:
+	struct FGlassesCooldown
+	{
+		FTiltFiveGlassesIdentifier Identifier;
+		double RetryTime = 0.0;
+		double Duration = 0.0;
+	};
+
+	int32 FindCooldown_ConnectionThread(const ANSICHAR* Id) const;
+	void UpdateOccupiedSlotMask();
+
+	mutable FRWLock SlotLock;
+	FTiltFiveGlassesIdentifier SlotIdentifiers[NumSlots];
+
+	std::atomic<uint32> OccupiedSlotMask{0};
+	std::atomic<int32> NumListedGlasses{0};
+	std::atomic<bool> bVersionCompatible{false};
+
+	// Connection thread only
+	double LastRefreshTime = -DBL_MAX;
+	FGlassesCooldown Cooldowns[MaxListedGlasses];
+	int32 NumCooldowns = 0;
+};
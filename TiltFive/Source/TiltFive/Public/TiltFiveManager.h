@@ -7,6 +7,9 @@
 //#include "TiltFiveXRBase.h"
 #include "TiltFiveManager.generated.h"
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FTiltFiveGlassesParamsChanged, int32, PlayerIndex);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FTiltFiveSystemParamsChanged);
+
 UCLASS()
 class TILTFIVE_API ATiltFiveManager : public AActor
 {
@@ -40,6 +43,14 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Tilt Five Manager")
 	uint8 spectatedPlayer;
 
+	// Called when the IPD or name of a player's glasses changed, including when the player got or lost glasses
+	UPROPERTY(BlueprintAssignable, Category = "Tilt Five Manager")
+	FTiltFiveGlassesParamsChanged OnGlassesParamsChanged;
+
+	// Called when the service version changed or the Tilt Five Control Panel started or stopped requesting attention
+	UPROPERTY(BlueprintAssignable, Category = "Tilt Five Manager")
+	FTiltFiveSystemParamsChanged OnSystemParamsChanged;
+
 	// Sets default values for this actor's properties
 	ATiltFiveManager();
 
@@ -47,9 +58,17 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 	void TrackPlayers();
+	void BroadcastParamChanges();
 
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+private:
+	// Parameter versions we already told Blueprints about
+	uint64 LastSystemParamsVersion = 0;
+	uint64 LastGlassesParamsVersions[4] = {};
+
+	// FOVs we last passed on to the glasses, negative so the first tick always applies them
+	float LastAppliedFOVs[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
 };
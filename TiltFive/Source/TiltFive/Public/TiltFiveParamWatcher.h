@@ -0,0 +1,98 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TiltFiveGlassesRegistry.h"
+#include "TiltFiveRingBuffer.h"
+#include "TiltFiveTypes.h"
+
+/** System wide parameters of the Tilt Five service. */
+struct FTiltFiveSystemParams
+{
+	// False until the service could be asked at least once
+	bool bValid;
+
+	// The Tilt Five Control Panel needs the user to do something, e.g. install an important firmware update
+	bool bUiRequestingAttention;
+
+	ANSICHAR ServiceVersion[T5_MAX_STRING_PARAM_LEN];
+};
+
+/** Parameters of one pair of exclusive glasses. */
+struct FTiltFiveGlassesParams
+{
+	// False while the player has no exclusive glasses
+	bool bValid;
+
+	// Interpupillary distance, as reported by the service
+	float IPD;
+
+	ANSICHAR FriendlyName[T5_MAX_STRING_PARAM_LEN];
+};
+
+/**
+ * Keeps a snapshot of the system parameters and of the parameters of every player's glasses.
+ *
+ * All parameters are read once and after that only re-read when the service reports them as changed, which happens on the
+ * connection thread. Any thread can get the latest snapshot without locking or talking to the service, and tell from the version
+ * whether anything changed since it last looked.
+ */
+class TILTFIVE_API FTiltFiveParamWatcher
+{
+public:
+	static constexpr int32 NumSlots = FTiltFiveGlassesRegistry::NumSlots;
+
+	/** Reads the system parameters that changed since the last call, or all of them on the first successful call. */
+	void UpdateSystemParams_ConnectionThread();
+
+	/**
+	 * Reads the parameters of the glasses of the given slot that changed since the last call. Reads all of them if bReadAll is set,
+	 * which has to be the case for the first call after the glasses became exclusive.
+	 *
+	 * Returns true if a new snapshot was published.
+	 */
+	bool UpdateGlassesParams_ConnectionThread(int32 Slot, FT5GlassesPtr Glasses, FCriticalSection& ExclusiveGroup1CriticalSection,
+		bool bReadAll);
+
+	/** Publishes an invalid snapshot for the given slot, after its glasses were released. */
+	void ClearGlassesParams_ConnectionThread(int32 Slot);
+
+	bool GetSystemParams(FTiltFiveSystemParams& OutParams) const;
+	bool GetGlassesParams(int32 Slot, FTiltFiveGlassesParams& OutParams) const;
+
+	/** Changes whenever a new snapshot of the system parameters is published. */
+	uint64 GetSystemParamsVersion() const
+	{
+		return SystemParams.GetNumPushed();
+	}
+
+	/** Changes whenever a new snapshot of the parameters of the given slot's glasses is published. */
+	uint64 GetGlassesParamsVersion(int32 Slot) const
+	{
+		return GlassesParams[Slot].GetNumPushed();
+	}
+
+private:
+	// Only the latest snapshot is ever read, the additional slots just give readers some slack
+	static constexpr uint32 SnapshotRingCapacity = 4;
+
+	TTiltFiveSeqlockRing<FTiltFiveSystemParams, SnapshotRingCapacity> SystemParams;
+	TTiltFiveSeqlockRing<FTiltFiveGlassesParams, SnapshotRingCapacity> GlassesParams[NumSlots];
+
+	// Connection thread copies of the latest snapshots, changes are applied to these before they are published
+	FTiltFiveSystemParams SystemParams_ConnectionThread{};
+	FTiltFiveGlassesParams GlassesParams_ConnectionThread[NumSlots]{};
+};
@@ -0,0 +1,188 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+#include <type_traits>
+
+/**
+ * Fixed size, single producer / multiple consumer ring of the most recently published elements.
+ *
+ * The producer never waits on consumers and consumers never block the producer or each other. Every slot carries a sequence
+ * number derived from the logical index of the element stored in it: odd while the producer is writing the slot, even once the
+ * element is complete. A reader copies the slot and only accepts the copy if the sequence number was the expected even value both
+ * before and after the copy, so torn reads and slots the producer already lapped are detected and retried.
+ *
+ * Only trivially copyable element types are supported, since readers may copy a slot while it is being overwritten.
+ */
+template <typename ElementType, uint32 Capacity>
+class TTiltFiveSeqlockRing
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+	static_assert(std::is_trivially_copyable<ElementType>::value, "Elements are copied while they may be overwritten");
+
+public:
+	TTiltFiveSeqlockRing() = default;
+	TTiltFiveSeqlockRing(const TTiltFiveSeqlockRing&) = delete;
+	TTiltFiveSeqlockRing& operator=(const TTiltFiveSeqlockRing&) = delete;
+
+	/** Publishes a new element. Must only ever be called from one thread at a time. */
+	void Push(const ElementType& Element)
+	{
+		const uint64 Index = WriteIndex.load(std::memory_order_relaxed);
+		FSlot& Slot = Slots[Index & (Capacity - 1)];
+
+		Slot.Sequence.store(Index * 2 + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		Slot.Element = Element;
+		Slot.Sequence.store(Index * 2 + 2, std::memory_order_release);
+
+		WriteIndex.store(Index + 1, std::memory_order_release);
+	}
+
+	/**
+	 * Copies the element published Age pushes ago (0 is the latest) into OutElement.
+	 *
+	 * Returns false if no such element was published yet, or if the producer kept overwriting it while we were trying to read it.
+	 */
+	bool Read(uint32 Age, ElementType& OutElement) const
+	{
+		// The newest slots are the ones the producer is least likely to be writing, so we keep one slot of slack.
+		if (Age >= Capacity - 1)
+		{
+			return false;
+		}
+
+		for (int32 Attempt = 0; Attempt < MaxReadAttempts; ++Attempt)
+		{
+			const uint64 Published = WriteIndex.load(std::memory_order_acquire);
+			if (Age >= Published)
+			{
+				return false;
+			}
+
+			const uint64 Index = Published - 1 - Age;
+			const FSlot& Slot = Slots[Index & (Capacity - 1)];
+			const uint64 ExpectedSequence = Index * 2 + 2;
+
+			if (Slot.Sequence.load(std::memory_order_acquire) != ExpectedSequence)
+			{
+				continue;
+			}
+
+			OutElement = Slot.Element;
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (Slot.Sequence.load(std::memory_order_relaxed) == ExpectedSequence)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/** Copies the most recently published element into OutElement. */
+	bool ReadLatest(ElementType& OutElement) const
+	{
+		return Read(0, OutElement);
+	}
+
+	/** Total number of elements pushed so far. Can be used by readers to detect new data without copying it. */
+	uint64 GetNumPushed() const
+	{
+		return WriteIndex.load(std::memory_order_acquire);
+	}
+
+private:
+	static constexpr int32 MaxReadAttempts = 8;
+
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FSlot
+	{
+		std::atomic<uint64> Sequence{0};
+		ElementType Element;
+	};
+
+	FSlot Slots[Capacity];
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> WriteIndex{0};
+};
+
+/**
+ * Fixed size, single producer / single consumer queue.
+ *
+ * Unlike TTiltFiveSeqlockRing every element is delivered exactly once, in order. The producer never waits: if the consumer falls
+ * a whole queue behind, Push fails and the element is dropped. Elements are only moved in and out by the thread owning that side,
+ * so any copyable type works. The producer and consumer may change over time, as long as the hand over synchronizes (e.g. a
+ * thread being joined).
+ */
+template <typename ElementType, uint32 Capacity>
+class TTiltFiveSpscQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	TTiltFiveSpscQueue() = default;
+	TTiltFiveSpscQueue(const TTiltFiveSpscQueue&) = delete;
+	TTiltFiveSpscQueue& operator=(const TTiltFiveSpscQueue&) = delete;
+
+	/** Appends an element. Producer only. Returns false, without modifying the queue, if it is full. */
+	bool Push(const ElementType& Element)
+	{
+		const uint64 Tail = TailIndex.load(std::memory_order_relaxed);
+		if (Tail - CachedHeadIndex >= Capacity)
+		{
+			CachedHeadIndex = HeadIndex.load(std::memory_order_acquire);
+			if (Tail - CachedHeadIndex >= Capacity)
+			{
+				return false;
+			}
+		}
+
+		Elements[Tail & (Capacity - 1)] = Element;
+		TailIndex.store(Tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Removes the oldest element. Consumer only. Returns false if the queue is empty. */
+	bool Pop(ElementType& OutElement)
+	{
+		const uint64 Head = HeadIndex.load(std::memory_order_relaxed);
+		if (Head == CachedTailIndex)
+		{
+			CachedTailIndex = TailIndex.load(std::memory_order_acquire);
+			if (Head == CachedTailIndex)
+			{
+				return false;
+			}
+		}
+
+		OutElement = Elements[Head & (Capacity - 1)];
+		HeadIndex.store(Head + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	ElementType Elements[Capacity];
+
+	// Producer side, CachedHeadIndex saves reading the consumer's cache line on every push
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> TailIndex{0};
+	uint64 CachedHeadIndex = 0;
+
+	// Consumer side
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> HeadIndex{0};
+	uint64 CachedTailIndex = 0;
+};
@@ -19,6 +19,28 @@
 
 #include "TiltFiveSettings.generated.h"
 
+/** How the glasses pose is extrapolated to the time the rendered frame reaches the displays */
+UENUM(BlueprintType)
+enum class ETiltFivePosePredictionMode : uint8
+{
+	// Use the latest pose reported by the service as-is
+	Disabled,
+	// Extrapolate with the linear and angular velocity of the most recent poses
+	ConstantVelocity,
+	// Extrapolate with an alpha-beta filtered pose and velocity, trading a little responsiveness for less jitter
+	Kalman UMETA(DisplayName = "Kalman (Alpha-Beta Filter)"),
+};
+
+/** How the dead zone of the wand stick is applied */
+UENUM(BlueprintType)
+enum class ETiltFiveStickDeadZoneMode : uint8
+{
+	// Each axis is dead on its own, which makes it easy to push the stick straight along one axis
+	Axial,
+	// The dead zone is a circle around the center, which keeps diagonal directions intact
+	Radial,
+};
+
 /**
  *
  */
@@ -44,4 +66,46 @@ public:
 	// empty project name will be used
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Applicaaiton Info", meta = (ConfigRestartRequired = true))
 	FString ApplicationDisplayName;
+
+	// Pose prediction used by glasses that don't have a mode set explicitly through the blueprint library
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Tracking")
+	ETiltFivePosePredictionMode PosePredictionMode = ETiltFivePosePredictionMode::ConstantVelocity;
+
+	// Latency between a frame being sent to the glasses and it being visible, added on top of the measured render latency when
+	// predicting poses
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Tracking", meta = (ClampMin = 0, ClampMax = 50, Units = "ms"))
+	float PosePredictionDisplayLatency = 0.0f;
+
+	// With OpenGL, send both eyes to the glasses as the two slices of one array texture instead of a pair of textures. The spectator
+	// screen shows the whole scene render target while this is in use.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Rendering", meta = (ConfigRestartRequired = true))
+	bool bUseEyeTextureArraysOnOpenGL = false;
+
+	// How the stick dead zone is shaped
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Input")
+	ETiltFiveStickDeadZoneMode StickDeadZoneMode = ETiltFiveStickDeadZoneMode::Axial;
+
+	// Stick deflection below which the stick reads as centered. The range above it is rescaled to start at zero.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (ClampMin = 0, ClampMax = 0.9))
+	float StickDeadZone = 0.15f;
+
+	// Trigger value below which the trigger reads as released. The range above it is rescaled to start at zero.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (ClampMin = 0, ClampMax = 0.9))
+	float TriggerDeadZone = 0.07f;
+
+	// Response curve of the stick, the rescaled deflection is raised to this power. Above 1 gives finer control around the center.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (ClampMin = 0.1, ClampMax = 5))
+	float StickResponseExponent = 1.0f;
+
+	// Response curve of the trigger, the rescaled value is raised to this power
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (ClampMin = 0.1, ClampMax = 5))
+	float TriggerResponseExponent = 1.0f;
+
+	// Time constant of the exponential smoothing applied to stick and trigger, 0 disables smoothing
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (ClampMin = 0, ClampMax = 200, Units = "ms"))
+	float AnalogSmoothingTime = 0.0f;
+
+	// Stick and trigger values are only sent to the input system once they moved by more than this since they were last sent
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (ClampMin = 0, ClampMax = 0.1))
+	float AnalogEventThreshold = 0.001f;
 };
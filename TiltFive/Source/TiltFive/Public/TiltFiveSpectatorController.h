@@ -5,6 +5,8 @@
 #include "ISpectatorScreenController.h"
 #include "HeadMountedDisplayTypes.h"
 #include "UObject/WeakObjectPtrTemplates.h"
+#include "TiltFiveCopyPass.h"
+#include "TiltFiveSpectatorLayout.h"
 #include "TiltFiveXRBase.h"
 
 class FTiltFiveXRBase;
@@ -31,6 +33,10 @@ public:
 	virtual void SetSpectatorScreenModeTexturePlusEyeLayout(const FSpectatorScreenModeTexturePlusEyeLayout& Layout) override;
 	virtual void QueueDebugCanvasLayerID(int32 LayerID) override;
 
+	/** Sets which players are shown and how, takes effect with the next rendered frame. */
+	void SetSpectatorLayout(const FTiltFiveSpectatorLayout& Layout);
+	FTiltFiveSpectatorLayout GetSpectatorLayout() const;
+
 	FSpectatorScreenRenderDelegate* GetSpectatorScreenRenderDelegate_RenderThread();
 
 
@@ -40,6 +46,18 @@ public:
 	virtual void RenderSpectatorScreen_RenderThread(FRHICommandListImmediate& RHICmdList, FRHITexture2D* BackBuffer, FTexture2DRHIRef SrcTexture, FVector2D WindowSize);
 	virtual void RenderSpectatorScreen_RenderThread(FRHICommandListImmediate& RHICmdList, FRHITexture2D* BackBuffer, FTexture2DRHIRef SrcTexture, FTexture2DRHIRef LayersTexture, FVector2D WindowSize);
 
+	/** Whether the current layout shows several players, in which case RenderSpectatorPlayers_RenderThread is used. */
+	bool IsMultiPlayerLayout_RenderThread() const;
+
+	/**
+	 * Draws the players of the current layout in a single pass. PlayerTextures holds the eye texture of every player, indexed by
+	 * player and null for players without one.
+	 */
+	void RenderSpectatorPlayers_RenderThread(FRHICommandListImmediate& RHICmdList, FRHITexture2D* BackBuffer, TArrayView<FRHITexture2D* const> PlayerTextures, int32 SpectatedPlayer);
+
+	/** Where each of NumTiles players is drawn in TargetRect for the given layout, in the order of the layout's players. */
+	static void GetLayoutTileRects(const FTiltFiveSpectatorLayout& Layout, int32 NumTiles, const FIntRect& TargetRect, TArray<FIntRect>& OutTileRects);
+
 protected:
 	friend struct FRHISetSpectatorScreenTexture;
 	virtual void SetSpectatorScreenTextureRenderCommand(UTexture* SrcTexture);
@@ -71,11 +89,17 @@ protected:
 	FSpectatorScreenRenderDelegate SpectatorScreenDelegate_RenderThread;
 	TArray<int32> DebugCanvasLayerIDs;
 
+	// Guarded by NewSpectatorScreenModeLock, picked up by UpdateSpectatorScreenMode_RenderThread
+	FTiltFiveSpectatorLayout NewSpectatorLayout;
+	bool bNewSpectatorLayoutPending = false;
+
+	FTiltFiveSpectatorLayout SpectatorLayout_RenderThread;
+
 		static FIntRect GetEyeCroppedToFitRect(FVector2D EyeCenterPoint, const FIntRect& EyeRect, const FIntRect& TargetRect);
 		static FIntRect GetLetterboxedDestRect(const FIntRect& SrcRect, const FIntRect& TargetRect);
 
 private:
-	void CopyEmulatedLayers(FRHICommandListImmediate& RHICmdList, FTexture2DRHIRef TargetTexture, const FIntRect SrcRect, const FIntRect DstRect);
+	void AddEmulatedLayersCopy(TArray<FTiltFiveTextureCopy, TInlineAllocator<4>>& Copies, const FIntRect SrcRect, const FIntRect DstRect);
 
 	FTiltFiveXRBase* HMDDevice;
 	// Face locked stereo layers are composited to a single texture which has to be copied over to the spectator screen.
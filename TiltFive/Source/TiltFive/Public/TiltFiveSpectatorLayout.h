@@ -0,0 +1,57 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "TiltFiveSpectatorLayout.generated.h"
+
+/** How the spectator screen arranges the players */
+UENUM(BlueprintType)
+enum class ETiltFiveSpectatorLayoutMode : uint8
+{
+	// Only the spectated player is shown, in the regular spectator screen mode
+	SinglePlayer,
+	// The players share the window in an evenly divided grid
+	Grid,
+	// The first player fills the window, the others are shown in small insets along the bottom
+	PictureInPicture,
+};
+
+/** Which players the spectator screen shows and how. */
+USTRUCT(BlueprintType)
+struct TILTFIVE_API FTiltFiveSpectatorLayout
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tilt Five|Spectator")
+	ETiltFiveSpectatorLayoutMode Mode = ETiltFiveSpectatorLayoutMode::SinglePlayer;
+
+	// Player indices to show, in order. Empty shows every player with glasses, starting with the spectated player.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tilt Five|Spectator")
+	TArray<int32> Players;
+
+	// Columns of the grid, 0 picks the most square grid for the number of players
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tilt Five|Spectator", meta = (ClampMin = 0, ClampMax = 4))
+	int32 GridColumns = 0;
+
+	// Height of the picture in picture insets, relative to the window height
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tilt Five|Spectator", meta = (ClampMin = 0.05, ClampMax = 0.5))
+	float InsetScale = 0.25f;
+
+	// Space between tiles and around insets, in pixels
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tilt Five|Spectator", meta = (ClampMin = 0))
+	int32 Padding = 4;
+};
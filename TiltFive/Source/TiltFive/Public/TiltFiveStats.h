@@ -0,0 +1,33 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("TiltFive"), STATGROUP_TiltFive, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Present"), STAT_TiltFivePresent, STATGROUP_TiltFive, TILTFIVE_API);
+
+// How long sending the last frame took, per pair of glasses
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Submit Player 1 (ms)"), STAT_TiltFiveSubmitMs0, STATGROUP_TiltFive, TILTFIVE_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Submit Player 2 (ms)"), STAT_TiltFiveSubmitMs1, STATGROUP_TiltFive, TILTFIVE_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Submit Player 3 (ms)"), STAT_TiltFiveSubmitMs2, STATGROUP_TiltFive, TILTFIVE_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Submit Player 4 (ms)"), STAT_TiltFiveSubmitMs3, STATGROUP_TiltFive, TILTFIVE_API);
+
+// Haptic impulses of all wands since startup: sent to the service, merged into another impulse, or never played
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Haptic Impulses Sent"), STAT_TiltFiveHapticsSent, STATGROUP_TiltFive, TILTFIVE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Haptic Impulses Merged"), STAT_TiltFiveHapticsMerged, STATGROUP_TiltFive, TILTFIVE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Haptic Impulses Dropped"), STAT_TiltFiveHapticsDropped, STATGROUP_TiltFive, TILTFIVE_API);
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
 #include "HeadMountedDisplayBase.h"
 #include "XRTrackingSystemBase.h"
 #include "IStereoLayers.h"
@@ -11,12 +12,15 @@
 #include "XRRenderBridge.h"
 #include "XRRenderTargetManager.h"
 #include "IXRTrackingSystem.h"
+#include "HMD/TiltFiveHMD.h"
+#include "TiltFiveCopyPass.h"
 #include "TiltFiveSpectatorController.h"
 #include "Runtime/Launch/Resources/Version.h"
 
 #include <atomic>
 
 class FTiltFiveXRBase;
+class FTiltFiveConnectionThread;
 
 namespace ETiltFiveDeviceId
 {
@@ -31,6 +35,43 @@ namespace ETiltFiveDeviceId
 	};
 }
 
+/** The player whose glasses a stereo view renders for, and which of their eyes. */
+struct FTiltFiveViewRoute
+{
+	int32 PlayerIndex = 0;
+	int32 EyeIndex = 0;
+
+	/**
+	 * Routes a stereo view to a player and eye. Views without a player index (INDEX_NONE) go to the default view player of the frame.
+	 * Returns false if the view isn't an eye view, in which case OutRoute names the player and the left eye. Pure, so it may be
+	 * called from any thread in any order.
+	 */
+	static bool Route(int32 ViewIndex, int32 PlayerIndex, int32 DefaultViewPlayerIndex, FTiltFiveViewRoute& OutRoute);
+};
+
+/**
+ * Everything needed to send one frame to one pair of glasses. The render thread fills a packet per glasses once the eyes are copied
+ * and hands them to the RHI thread, so Present never has to look at render thread state.
+ */
+struct FTiltFiveSubmitPacket
+{
+	bool bValid = false;
+	int32 DeviceId = 0;
+	FT5GlassesPtr Glasses = nullptr;
+
+	// The textures behind the handles in FrameInfo, kept alive until the frame is sent. Vulkan handles are filled in on send.
+	FTextureRHIRef Textures[NumEyeRenderTargets];
+	bool bUsesTextureArray = false;
+
+	FT5FrameInfo FrameInfo;
+
+	// When the poses the frame was rendered with were taken, for the latency estimates
+	double RenderThreadPoseTime = 0.0;
+	double GameThreadPoseTime = 0.0;
+};
+
+typedef TStaticArray<FTiltFiveSubmitPacket, FTiltFiveGlassesRegistry::NumSlots> FTiltFiveSubmitPackets;
+
 class FTiltFiveCustomPresent : public FXRRenderBridge
 {
 public:
@@ -38,10 +79,24 @@ public:
 	virtual bool NeedsNativePresent() override;
 	virtual bool Present(int32& InOutSyncInterval) override;
 
-	void UpdateViewport(const class FViewport& Viewport, class FRHIViewport* InViewportRHI) override;
+	/** Takes the packets of the next frame to present. Enqueued on the RHI command list by the render thread. */
+	void SetSubmitPackets_RHIThread(const FTiltFiveSubmitPackets& Packets);
 
 private:
+	struct FTiltFiveSubmitResult
+	{
+		bool bGraphicsContextInitialized = false;
+		FT5Result SendResult = T5_SUCCESS;
+		double SentTime = 0.0;
+		double SubmitSeconds = 0.0;
+	};
+
+	/** Sends one packet to its glasses. Must be called on the thread that provided the graphics context. */
+	FTiltFiveSubmitResult SubmitPacket_RHIThread(const FTiltFiveSubmitPacket& Packet, ET5GraphicsAPI GraphicsAPI) const;
+
 	TArray<TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe>> GlassesList;
+
+	FTiltFiveSubmitPackets SubmitPackets_RHIThread;
 };
 
 /**
@@ -65,6 +120,15 @@ public:
 	virtual bool IsVersionCompatible() const;
 	virtual void SetSpectatedPlayer(int32 DeviceId) const;
 
+	/** Sets which players the spectator screen shows and how. */
+	void SetSpectatorLayout(const FTiltFiveSpectatorLayout& Layout);
+
+	/** Eye resolution reported by the first glasses that were readied. Returns false if none were. */
+	bool GetNativeEyeSize(FIntPoint& OutEyeSize) const;
+
+	/** Layout of the scene render target for the frame the calling (game or render) thread works on. */
+	const FTiltFiveAtlasLayout& GetAtlasLayout() const;
+
 	virtual int32 GetXRSystemFlags() const override;
 	virtual bool DoesSupportPositionalTracking() const override;
 	virtual bool DoesSupportLateUpdate() const override;
@@ -130,6 +194,12 @@ public:
 	virtual IStereoRenderTargetManager* GetRenderTargetManager() override;
 	virtual void CalculateStereoViewOffset(const int32 ViewIndex, FRotator& ViewRotation, const float WorldToMeters, FVector& ViewLocation) override;
 	void CalculateStereoViewOffset(const int32 ViewIndex, FRotator& ViewRotation, const float WorldToMeters, FVector& ViewLocation, int32 playerIndex);
+
+	/**
+	 * Works out which player and eye a stereo view renders. Views without a player index (INDEX_NONE) are routed through the
+	 * current frame state. Returns false if the view isn't an eye view, in which case OutRoute names the player and the left eye.
+	 */
+	bool RouteStereoView(int32 ViewIndex, int32 PlayerIndex, FTiltFiveViewRoute& OutRoute) const;
 	virtual FIntRect GetFullFlatEyeRect_RenderThread(FTexture2DRHIRef EyeTexture) const { return FIntRect(0, 0, 1, 1); }
 	virtual FVector2D GetEyeCenterPoint_RenderThread(const int32 ViewIndex) const;
 
@@ -149,6 +219,15 @@ public:
 		FIntRect DstRect,
 		bool bClearBlack) const;
 #endif
+
+	/**
+	 * Draws the copies into DstTexture in order. Where the engine supports it they share a single render pass and cached pipeline
+	 * state, so prefer this over several CopyTexture_RenderThread calls when the copies have the same target.
+	 */
+	void CopyTextures_RenderThread(FRHICommandListImmediate& RHICmdList,
+		FRHITexture2D* DstTexture,
+		TArrayView<const FTiltFiveTextureCopy> Copies,
+		bool bClearBlack) const;
 	// /IStereoRendering Interface
 
 	// IStereoLayer Interface
@@ -178,23 +257,42 @@ public:
 #endif
 	// /IFXRRenderTargetManager Interface
 
-	FTiltFiveWorldStatePtr CurrentWorldState;
-	FTiltFiveWorldStatePtr RenderThreadWorldState;
+	FTiltFiveFrameStateRing FrameStates;
+
+	const FTiltFiveFrameState* FrameState_GameThread = nullptr;
+	const FTiltFiveFrameState* FrameState_RenderThread = nullptr;
+
+	void SetFrameState_RenderThread(const FTiltFiveFrameState& FrameState);
+
+	/**
+	 * Gives every player in the atlas eye textures (or an eye texture array) of the atlas eye size, and frees the textures of
+	 * everyone else.
+	 */
+	void UpdateEyeTextures_RenderThread(const FTiltFiveAtlasLayout& Atlas, ETextureCreateFlags SRGBFlag, bool bTextureArrays) const;
+
+	/** Captures what Present needs to send this frame to every pair of glasses, and hands it to the RHI thread. */
+	void EnqueueSubmitPackets_RenderThread(FRHICommandListImmediate& RHICmdList) const;
 
-	mutable bool bVersionCompatible = false;
-	float LastGlassesUpdate = -1.0f;
 	bool bEnableStereo = true;
 
+	// Which glasses the service lists and which player they belong to, shared by all players
+	FTiltFiveGlassesRegistry GlassesRegistry;
+
+	// Latest system and glasses parameters, kept up to date by the connection thread
+	FTiltFiveParamWatcher ParamWatcher;
+
 	TArray<TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe>> GlassesList;
 
+	// Connection state changes of all glasses, broadcast at the start of the game frame
+	FTiltFiveGlassesStateChanged OnGlassesStateChanged;
+
 	TRefCountPtr<FTiltFiveCustomPresent> CustomPresent;
 
 	static const FName TiltFiveSystemName;
 
-	mutable int stereoPassCount = 0;
 	mutable int32 currentSpectatedPlayer = 0;
 
-	static const int32 GMaxNumTiltFiveGlasses = 4;
+	static const int32 GMaxNumTiltFiveGlasses = FTiltFiveGlassesRegistry::NumSlots;
 
 	//This stuff is for the Spectator Controller
 	virtual void BeginRenderViewFamily(FSceneViewFamily& InViewFamily);
@@ -205,6 +303,12 @@ public:
 
 	class IRendererModule* RendererModule;
 
+#if UE_VERSION_NEWER_THAN(4, 25, 4)
+	mutable FTiltFiveCopyPass CopyPass_RenderThread;
+#endif
+
+	TUniquePtr<FTiltFiveConnectionThread> ConnectionThread;
+
 	protected:
 		virtual class FXRRenderBridge* GetActiveRenderBridge_GameThread(bool bUseSeparateRenderTarget) override;
 
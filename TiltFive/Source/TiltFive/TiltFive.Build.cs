@@ -79,6 +79,19 @@ public class TiltFive : ModuleRules
 				});
 		}
 
+		// Vulkan frame submission needs the native handles IVulkanDynamicRHI only exposes from 5.1 on
+		if (Target.Version.MajorVersion == 5 && Target.Version.MinorVersion >= 1 &&
+			(Target.Platform == UnrealTargetPlatform.Win64 || Target.Platform == UnrealTargetPlatform.Linux))
+		{
+			PrivateDependencyModuleNames.Add("VulkanRHI");
+			AddEngineThirdPartyPrivateStaticDependencies(Target, "Vulkan");
+			PrivateDefinitions.Add("TILTFIVE_WITH_VULKAN=1");
+		}
+		else
+		{
+			PrivateDefinitions.Add("TILTFIVE_WITH_VULKAN=0");
+		}
+
 		if (Target.Type == TargetType.Editor)
 		{
 			PrivateDependencyModuleNames.AddRange(new string[]
@@ -0,0 +1,157 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "Misc/AutomationTest.h"
+#include "TiltFiveAnalogProcessor.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiltFiveAnalogProcessorTest,
+	"TiltFive.Input.AnalogProcessor",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiltFiveAnalogProcessorTest::RunTest(const FString& Parameters)
+{
+	static constexpr float Tolerance = 1.e-5f;
+
+	FTiltFiveAnalogSettings Settings;
+	Settings.StickDeadZone = 0.15f;
+	Settings.TriggerDeadZone = 0.1f;
+	Settings.SmoothingTimeSeconds = 0.0f;
+
+	const auto Process = [&Settings](const FVector2D& RawStick, float RawTrigger)
+	{
+		FTiltFiveAnalogState State;
+		State.Process(Settings, RawStick, RawTrigger, 1.0f / 60.0f);
+		return State;
+	};
+
+	// Axial: every axis is dead on its own and the rest of its range is rescaled to start at zero
+	{
+		Settings.StickDeadZoneMode = ETiltFiveStickDeadZoneMode::Axial;
+		FTiltFiveAnalogState State = Process(FVector2D(0.1f, -0.1f), 0.05f);
+		TestTrue(TEXT("Axial: stick inside the dead zone is centered"), State.Stick.IsZero());
+		TestEqual(TEXT("Axial: trigger inside the dead zone is released"), State.Trigger, 0.0f);
+
+		State = Process(FVector2D(0.5f, -0.1f), 0.55f);
+		TestTrue(TEXT("Axial: rescaled X, Y inside the dead zone stays centered next to it"),
+			State.Stick.Equals(FVector2D((0.5f - 0.15f) / 0.85f, 0.0f), Tolerance));
+		TestEqual(TEXT("Axial: rescaled trigger"), State.Trigger, 0.5f, Tolerance);
+
+		State = Process(FVector2D(-1.0f, 1.2f), 1.0f);
+		TestTrue(TEXT("Axial: full deflection, deflection past the end is clamped"),
+			State.Stick.Equals(FVector2D(-1.0f, 1.0f), Tolerance));
+		TestEqual(TEXT("Axial: full trigger"), State.Trigger, 1.0f, Tolerance);
+
+		State = Process(FVector2D(0.12f, 0.12f), 0.0f);
+		TestTrue(TEXT("Axial: small diagonals are dead"), State.Stick.IsZero());
+	}
+
+	// Radial: the dead zone is a circle and the direction of the stick is kept
+	{
+		Settings.StickDeadZoneMode = ETiltFiveStickDeadZoneMode::Radial;
+		FTiltFiveAnalogState State = Process(FVector2D(0.1f, 0.1f), 0.0f);
+		TestTrue(TEXT("Radial: stick inside the dead circle is centered"), State.Stick.IsZero());
+
+		const FVector2D RawStick(0.12f, 0.12f);
+		State = Process(RawStick, 0.0f);
+		const float Deflection = (static_cast<float>(RawStick.Size()) - 0.15f) / 0.85f;
+		TestTrue(TEXT("Radial: rescaled deflection in the raw direction"),
+			State.Stick.Equals(RawStick.GetSafeNormal() * Deflection, Tolerance));
+
+		State = Process(FVector2D(0.0f, -1.0f), 0.0f);
+		TestTrue(TEXT("Radial: full deflection"), State.Stick.Equals(FVector2D(0.0f, -1.0f), Tolerance));
+	}
+
+	// The response curve bends the rescaled range, its ends stay put
+	{
+		Settings.StickDeadZoneMode = ETiltFiveStickDeadZoneMode::Axial;
+		Settings.StickResponseExponent = 2.0f;
+		Settings.TriggerResponseExponent = 3.0f;
+
+		FTiltFiveAnalogState State = Process(FVector2D(0.15f + 0.85f * 0.5f, 1.0f), 0.1f + 0.9f * 0.5f);
+		TestTrue(TEXT("Stick response exponent, full deflection kept"), State.Stick.Equals(FVector2D(0.25f, 1.0f), Tolerance));
+		TestEqual(TEXT("Trigger response exponent"), State.Trigger, 0.125f, Tolerance);
+
+		State = Process(FVector2D(-0.15f - 0.85f * 0.5f, 0.0f), 1.0f);
+		TestTrue(TEXT("Stick response keeps the sign"), State.Stick.Equals(FVector2D(-0.25f, 0.0f), Tolerance));
+		TestEqual(TEXT("Trigger response keeps full pull"), State.Trigger, 1.0f, Tolerance);
+
+		Settings.StickResponseExponent = 1.0f;
+		Settings.TriggerResponseExponent = 1.0f;
+	}
+
+	// Without smoothing, and for frames without time passing, the target is reached at once
+	{
+		FTiltFiveAnalogState State;
+		TestFalse(TEXT("Nothing to settle without smoothing"), State.Process(Settings, FVector2D(1.0f, 0.0f), 1.0f, 1.0f / 60.0f));
+		TestEqual(TEXT("Unsmoothed trigger"), State.Trigger, 1.0f, Tolerance);
+
+		Settings.SmoothingTimeSeconds = 0.05f;
+		State = FTiltFiveAnalogState();
+		TestFalse(TEXT("Nothing to settle without time passing"), State.Process(Settings, FVector2D(1.0f, 0.0f), 1.0f, 0.0f));
+		TestEqual(TEXT("Trigger without time passing"), State.Trigger, 1.0f, Tolerance);
+	}
+
+	// Smoothing converges exponentially, independent of the frame rate, and snaps once the rest is below the event threshold
+	{
+		Settings.SmoothingTimeSeconds = 0.05f;
+		Settings.EventThreshold = 0.001f;
+
+		for (int32 FrameRate : {30, 60, 120, 240})
+		{
+			const FString Context = FString::Printf(TEXT("%d Hz"), FrameRate);
+			const float DeltaTime = 1.0f / FrameRate;
+
+			FTiltFiveAnalogState State;
+			float PreviousTrigger = 0.0f;
+			int32 NumSettlingFrames = 0;
+			int32 NumNonIncreasingFrames = 0;
+			bool bSettling = true;
+			while (bSettling && NumSettlingFrames < FrameRate * 10)
+			{
+				bSettling = State.Process(Settings, FVector2D(1.0f, 0.0f), 1.0f, DeltaTime);
+				NumNonIncreasingFrames += State.Trigger <= PreviousTrigger ? 1 : 0;
+				NumNonIncreasingFrames += State.Trigger > 1.0f ? 1 : 0;
+				PreviousTrigger = State.Trigger;
+				++NumSettlingFrames;
+
+				// About one smoothing time in, the remaining distance follows the same exponential whatever the frame rate
+				if (NumSettlingFrames * DeltaTime > Settings.SmoothingTimeSeconds - KINDA_SMALL_NUMBER &&
+					(NumSettlingFrames - 1) * DeltaTime < Settings.SmoothingTimeSeconds - KINDA_SMALL_NUMBER)
+				{
+					const float ExpectedTrigger = 1.0f - FMath::Exp(-NumSettlingFrames * DeltaTime / Settings.SmoothingTimeSeconds);
+					TestEqual(Context + TEXT(": trigger after one smoothing time"), State.Trigger, ExpectedTrigger, 1.e-3f);
+				}
+			}
+
+			TestFalse(Context + TEXT(": smoothing settles"), bSettling);
+			TestEqual(Context + TEXT(": trigger moves towards the target every frame without overshooting"), NumNonIncreasingFrames, 0);
+			TestEqual(Context + TEXT(": trigger snapped onto the target"), State.Trigger, 1.0f);
+			TestTrue(Context + TEXT(": stick snapped onto the target"), State.Stick == FVector2D(1.0f, 0.0f));
+
+			// Ln(1 / threshold) smoothing times until the rest is below the threshold, give or take a frame
+			const float ExpectedSeconds = Settings.SmoothingTimeSeconds * FMath::Loge(1.0f / Settings.EventThreshold);
+			TestEqual(Context + TEXT(": time to settle"), NumSettlingFrames * DeltaTime, ExpectedSeconds, DeltaTime + KINDA_SMALL_NUMBER);
+
+			// Once settled, the same input doesn't need another frame
+			TestFalse(Context + TEXT(": stays settled"), State.Process(Settings, FVector2D(1.0f, 0.0f), 1.0f, DeltaTime));
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,104 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "Misc/AutomationTest.h"
+#include "TiltFiveInputTimeline.h"
+#include "TiltFiveKeys.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	FTiltFiveButtonEdge MakeEdge(int32 PlayerIndex, const FKey& Key, bool bPressed, double TimeSeconds)
+	{
+		FTiltFiveButtonEdge Edge;
+		Edge.PlayerIndex = PlayerIndex;
+		Edge.Key = Key;
+		Edge.bPressed = bPressed;
+		Edge.TimeSeconds = TimeSeconds;
+		return Edge;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiltFiveInputTimelineTest,
+	"TiltFive.Input.InputTimeline",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiltFiveInputTimelineTest::RunTest(const FString& Parameters)
+{
+	static constexpr int32 Capacity = FTiltFiveInputTimeline::Capacity;
+
+	const FKey& KeyOne = ETiltFiveKeys::WandR_One;
+	const FKey& KeyTwo = ETiltFiveKeys::WandR_Two;
+
+	FTiltFiveInputTimeline Timeline;
+	double Time = 0.0;
+	TestFalse(TEXT("No press before the first edge"), Timeline.GetLastPressTime(0, KeyOne, Time));
+	TestFalse(TEXT("No release before the first edge"), Timeline.GetLastReleaseTime(0, KeyOne, Time));
+
+	// The latest press and release are looked up per player and key
+	Timeline.Add(MakeEdge(0, KeyOne, true, 1.0));
+	Timeline.Add(MakeEdge(1, KeyOne, true, 1.5));
+	Timeline.Add(MakeEdge(0, KeyOne, false, 2.0));
+	Timeline.Add(MakeEdge(0, KeyTwo, true, 2.5));
+	Timeline.Add(MakeEdge(0, KeyOne, true, 3.0));
+
+	TestTrue(TEXT("Player 0 pressed one"), Timeline.GetLastPressTime(0, KeyOne, Time));
+	TestEqual(TEXT("Latest press of one by player 0"), Time, 3.0);
+	TestTrue(TEXT("Player 0 released one"), Timeline.GetLastReleaseTime(0, KeyOne, Time));
+	TestEqual(TEXT("Latest release of one by player 0"), Time, 2.0);
+	TestTrue(TEXT("Player 1 pressed one"), Timeline.GetLastPressTime(1, KeyOne, Time));
+	TestEqual(TEXT("Presses of other players don't count"), Time, 1.5);
+	TestFalse(TEXT("Player 1 never released one"), Timeline.GetLastReleaseTime(1, KeyOne, Time));
+	TestTrue(TEXT("Player 0 pressed two"), Timeline.GetLastPressTime(0, KeyTwo, Time));
+	TestEqual(TEXT("Presses of other keys don't count"), Time, 2.5);
+	TestFalse(TEXT("Player 2 never pressed anything"), Timeline.GetLastPressTime(2, KeyOne, Time));
+
+	TArray<FTiltFiveButtonEdge> Edges;
+	TestEqual(TEXT("Edges after 1.5"), Timeline.GetEdgesSince(1.5, Edges), 3);
+	TestTrue(TEXT("Edges after 1.5 in dispatch order"),
+		Edges.Num() == 3 && Edges[0].TimeSeconds == 2.0 && Edges[1].TimeSeconds == 2.5 && Edges[2].TimeSeconds == 3.0);
+
+	// Fill the ring up so the first edges are overwritten, only the newest Capacity edges are kept
+	for (int32 Index = 0; Index < Capacity - 1; ++Index)
+	{
+		Timeline.Add(MakeEdge(3, KeyTwo, (Index & 1) == 0, 10.0 + Index));
+	}
+	TestEqual(TEXT("Edges counted across wrap-around"), static_cast<int64>(Timeline.GetNumEdges()), static_cast<int64>(Capacity + 4));
+
+	TestFalse(TEXT("The press of player 1 was overwritten"), Timeline.GetLastPressTime(1, KeyOne, Time));
+	TestFalse(TEXT("The release of player 0 was overwritten"), Timeline.GetLastReleaseTime(0, KeyOne, Time));
+	TestTrue(TEXT("The latest press of player 0 is still kept"), Timeline.GetLastPressTime(0, KeyOne, Time));
+	TestEqual(TEXT("The oldest kept edge"), Time, 3.0);
+
+	// The last edge added at an even index was a press, the one after it a release
+	TestTrue(TEXT("Player 3 pressed two"), Timeline.GetLastPressTime(3, KeyTwo, Time));
+	TestEqual(TEXT("Latest press of two by player 3 after wrap-around"), Time, 10.0 + (Capacity - 2));
+	TestTrue(TEXT("Player 3 released two"), Timeline.GetLastReleaseTime(3, KeyTwo, Time));
+	TestEqual(TEXT("Latest release of two by player 3 after wrap-around"), Time, 10.0 + (Capacity - 3));
+
+	Edges.Reset();
+	TestEqual(TEXT("Every kept edge"), Timeline.GetEdgesSince(-1.0, Edges), Capacity);
+	bool bInOrder = Edges.Num() == Capacity && Edges[0].TimeSeconds == 3.0;
+	for (int32 Index = 1; Index < Edges.Num() && bInOrder; ++Index)
+	{
+		bInOrder = Edges[Index].TimeSeconds == 10.0 + (Index - 1);
+	}
+	TestTrue(TEXT("Kept edges in dispatch order after wrap-around"), bInOrder);
+
+	return true;
+}
+
+#endif
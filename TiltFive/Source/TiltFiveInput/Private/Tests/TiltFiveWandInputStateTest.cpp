@@ -0,0 +1,138 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "TiltFiveInputDevice.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/** What FindSlotsToSend computes, one value at a time. */
+	uint32 FindSlotsToSendScalar(const FTiltFiveWandInputState& Old, const FTiltFiveWandInputState& New, float AnalogEpsilon)
+	{
+		uint32 SlotsToSend = 0;
+		for (int32 Slot = 0; Slot < FTiltFiveWandInputState::NumSlots; ++Slot)
+		{
+			const uint32 SlotBit = FTiltFiveWandStateStore::GetSlotBit(Slot);
+			bool bChanged = ((Old.ConnectedMask ^ New.ConnectedMask) & SlotBit) != 0 ||
+				((Old.ButtonsValidMask ^ New.ButtonsValidMask) & SlotBit) != 0 ||
+				((Old.AnalogValidMask ^ New.AnalogValidMask) & SlotBit) != 0 || Old.Buttons[Slot] != New.Buttons[Slot];
+			for (int32 Lane = 0; Lane < 4; ++Lane)
+			{
+				bChanged |= FMath::Abs(New.Analog[Slot][Lane] - Old.Analog[Slot][Lane]) > AnalogEpsilon;
+			}
+			SlotsToSend |= bChanged ? SlotBit : 0;
+		}
+		return SlotsToSend;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiltFiveWandInputStateTest,
+	"TiltFive.Input.WandInputState",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiltFiveWandInputStateTest::RunTest(const FString& Parameters)
+{
+	static constexpr float Epsilon = 0.001f;
+	static constexpr int32 NumSlots = FTiltFiveWandInputState::NumSlots;
+
+	FTiltFiveWandInputState Old;
+	Old.ConnectedMask = Old.ButtonsValidMask = Old.AnalogValidMask = (1u << NumSlots) - 1;
+	for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+	{
+		Old.Buttons[Slot] = static_cast<uint8>(0x11 * Slot);
+		Old.Analog[Slot][0] = 0.5f;
+		Old.Analog[Slot][1] = -0.25f;
+		Old.Analog[Slot][2] = 0.75f;
+	}
+	const auto FindSlotsToSend = [&Old](const FTiltFiveWandInputState& New)
+	{
+		return static_cast<int32>(FTiltFiveWandInputState::FindSlotsToSend(Old, New, Epsilon));
+	};
+	TestEqual(TEXT("Nothing to send without changes"), FindSlotsToSend(Old), 0);
+
+	// Each change of one slot only sends that slot
+	for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+	{
+		const int32 SlotBit = static_cast<int32>(FTiltFiveWandStateStore::GetSlotBit(Slot));
+		const FString Context = FString::Printf(TEXT("slot %d"), Slot);
+
+		for (int32 Button = 0; Button < 8; ++Button)
+		{
+			FTiltFiveWandInputState New = Old;
+			New.Buttons[Slot] ^= static_cast<uint8>(1 << Button);
+			TestEqual(Context + FString::Printf(TEXT(": button %d flipped"), Button), FindSlotsToSend(New), SlotBit);
+		}
+
+		// Stick X, stick Y and trigger each sit in their own lane, and moving either way counts
+		for (int32 Lane = 0; Lane < 3; ++Lane)
+		{
+			for (float Direction : {1.0f, -1.0f})
+			{
+				FTiltFiveWandInputState New = Old;
+				New.Analog[Slot][Lane] += Direction * Epsilon * 2.0f;
+				TestEqual(Context + FString::Printf(TEXT(": lane %d moved past epsilon"), Lane), FindSlotsToSend(New), SlotBit);
+
+				New.Analog[Slot][Lane] = Old.Analog[Slot][Lane] + Direction * Epsilon * 0.5f;
+				TestEqual(Context + FString::Printf(TEXT(": lane %d moved within epsilon"), Lane), FindSlotsToSend(New), 0);
+			}
+		}
+
+		uint32 FTiltFiveWandInputState::*const Masks[] = {
+			&FTiltFiveWandInputState::ConnectedMask,
+			&FTiltFiveWandInputState::ButtonsValidMask,
+			&FTiltFiveWandInputState::AnalogValidMask};
+		for (uint32 FTiltFiveWandInputState::*Mask : Masks)
+		{
+			FTiltFiveWandInputState New = Old;
+			New.*Mask ^= FTiltFiveWandStateStore::GetSlotBit(Slot);
+			TestEqual(Context + TEXT(": mask flipped"), FindSlotsToSend(New), SlotBit);
+		}
+	}
+
+	// Random changes to random slots, checked against a plain per value comparison
+	FRandomStream Random(20);
+	int32 NumMismatches = 0;
+	for (int32 Iteration = 0; Iteration < 1000; ++Iteration)
+	{
+		FTiltFiveWandInputState New = Old;
+		const int32 NumChanges = Random.RandRange(0, 4);
+		for (int32 Change = 0; Change < NumChanges; ++Change)
+		{
+			const int32 Slot = Random.RandRange(0, NumSlots - 1);
+			switch (Random.RandRange(0, 2))
+			{
+			case 0:
+				New.Buttons[Slot] = static_cast<uint8>(Random.RandRange(0, 255));
+				break;
+			case 1:
+				New.Analog[Slot][Random.RandRange(0, 2)] += Random.FRandRange(-4.0f, 4.0f) * Epsilon;
+				break;
+			default:
+				New.ConnectedMask ^= FTiltFiveWandStateStore::GetSlotBit(Slot);
+				break;
+			}
+		}
+
+		NumMismatches += FindSlotsToSend(New) != static_cast<int32>(FindSlotsToSendScalar(Old, New, Epsilon)) ? 1 : 0;
+	}
+	TestEqual(TEXT("Slots differing from the per value comparison"), NumMismatches, 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,98 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "TiltFiveAnalogProcessor.h"
+
+FTiltFiveAnalogSettings FTiltFiveAnalogSettings::FromProjectSettings()
+{
+	const UTiltFiveSettings* ProjectSettings = GetDefault<UTiltFiveSettings>();
+
+	FTiltFiveAnalogSettings Settings;
+	Settings.StickDeadZoneMode = ProjectSettings->StickDeadZoneMode;
+	Settings.StickDeadZone = FMath::Clamp(ProjectSettings->StickDeadZone, 0.0f, 0.9f);
+	Settings.TriggerDeadZone = FMath::Clamp(ProjectSettings->TriggerDeadZone, 0.0f, 0.9f);
+	Settings.StickResponseExponent = FMath::Max(ProjectSettings->StickResponseExponent, 0.1f);
+	Settings.TriggerResponseExponent = FMath::Max(ProjectSettings->TriggerResponseExponent, 0.1f);
+	Settings.SmoothingTimeSeconds = FMath::Max(ProjectSettings->AnalogSmoothingTime, 0.0f) / 1000.0f;
+	Settings.EventThreshold = FMath::Max(ProjectSettings->AnalogEventThreshold, 0.0f);
+	return Settings;
+}
+
+// Maps Value (>= 0) from [DeadZone, 1] to [0, 1] and applies the response curve
+static float ApplyResponse(float Value, float DeadZone, float Exponent)
+{
+	if (Value <= DeadZone)
+	{
+		return 0.0f;
+	}
+
+	const float Rescaled = FMath::Min((Value - DeadZone) / (1.0f - DeadZone), 1.0f);
+	return Exponent == 1.0f ? Rescaled : FMath::Pow(Rescaled, Exponent);
+}
+
+static FVector2D ApplyStickResponse(const FTiltFiveAnalogSettings& Settings, const FVector2D& RawStick)
+{
+	if (Settings.StickDeadZoneMode == ETiltFiveStickDeadZoneMode::Radial)
+	{
+		const float Deflection = RawStick.Size();
+		if (Deflection <= Settings.StickDeadZone)
+		{
+			return FVector2D::ZeroVector;
+		}
+		return RawStick / Deflection * ApplyResponse(Deflection, Settings.StickDeadZone, Settings.StickResponseExponent);
+	}
+
+	return FVector2D(
+		FMath::Sign(RawStick.X) * ApplyResponse(FMath::Abs(RawStick.X), Settings.StickDeadZone, Settings.StickResponseExponent),
+		FMath::Sign(RawStick.Y) * ApplyResponse(FMath::Abs(RawStick.Y), Settings.StickDeadZone, Settings.StickResponseExponent));
+}
+
+bool FTiltFiveAnalogState::Process(const FTiltFiveAnalogSettings& Settings, const FVector2D& RawStick, float RawTrigger, float DeltaTime)
+{
+	const FVector2D TargetStick = ApplyStickResponse(Settings, RawStick);
+	const float TargetTrigger = ApplyResponse(RawTrigger, Settings.TriggerDeadZone, Settings.TriggerResponseExponent);
+
+	if (Settings.SmoothingTimeSeconds <= 0.0f || DeltaTime <= 0.0f)
+	{
+		Stick = TargetStick;
+		Trigger = TargetTrigger;
+		return false;
+	}
+
+	// Frame rate independent exponential smoothing
+	const float Alpha = 1.0f - FMath::Exp(-DeltaTime / Settings.SmoothingTimeSeconds);
+	Stick = FMath::Lerp(Stick, TargetStick, Alpha);
+	Trigger = FMath::Lerp(Trigger, TargetTrigger, Alpha);
+
+	// Snap once the remaining distance wouldn't be sent anyway, so settling ends
+	const float SnapDistance = FMath::Max(Settings.EventThreshold, KINDA_SMALL_NUMBER);
+	bool bSettling = false;
+	if (FVector2D::Distance(Stick, TargetStick) <= SnapDistance)
+	{
+		Stick = TargetStick;
+	}
+	else
+	{
+		bSettling = true;
+	}
+	if (FMath::Abs(Trigger - TargetTrigger) <= SnapDistance)
+	{
+		Trigger = TargetTrigger;
+	}
+	else
+	{
+		bSettling = true;
+	}
+	return bSettling;
+}
@@ -0,0 +1,50 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TiltFiveSettings.h"
+
+/** The analog input settings of the project, copied out once per frame. */
+struct FTiltFiveAnalogSettings
+{
+	ETiltFiveStickDeadZoneMode StickDeadZoneMode = ETiltFiveStickDeadZoneMode::Axial;
+	float StickDeadZone = 0.15f;
+	float TriggerDeadZone = 0.07f;
+	float StickResponseExponent = 1.0f;
+	float TriggerResponseExponent = 1.0f;
+	float SmoothingTimeSeconds = 0.0f;
+	float EventThreshold = 0.001f;
+
+	static FTiltFiveAnalogSettings FromProjectSettings();
+};
+
+/** Stick and trigger of one wand on their way from the raw reports to the input system. */
+struct FTiltFiveAnalogState
+{
+	// Values after dead zone, response curve and smoothing
+	FVector2D Stick = FVector2D::ZeroVector;
+	float Trigger = 0.0f;
+
+	// Values last sent to the input system
+	FVector2D SentStick = FVector2D::ZeroVector;
+	float SentTrigger = 0.0f;
+
+	/**
+	 * Moves the processed values towards the given raw values. Returns true while smoothing hasn't caught up with them yet, in which
+	 * case this has to be called again next frame even without new reports.
+	 */
+	bool Process(const FTiltFiveAnalogSettings& Settings, const FVector2D& RawStick, float RawTrigger, float DeltaTime);
+};
@@ -39,9 +39,10 @@ TSharedPtr<class IInputDevice> FTiltFiveInputModule::CreateInputDevice(
 	const TSharedRef<FGenericApplicationMessageHandler>& InMessageHandler)
 {
 #if UE_VERSION_OLDER_THAN(5, 3, 0)
-	return MakeShared<FTiltFiveInputDevice>(FTiltFiveModule::Get().GetHMD(), InMessageHandler);
+	return MakeShared<FTiltFiveInputDevice>(FTiltFiveModule::Get().GetHMD(), InMessageHandler, InputTimeline);
 #else
-	TSharedPtr<FTiltFiveInputDevice> inputDevice (new FTiltFiveInputDevice(FTiltFiveModule::Get().GetHMD(), InMessageHandler));
+	TSharedPtr<FTiltFiveInputDevice> inputDevice (
+		new FTiltFiveInputDevice(FTiltFiveModule::Get().GetHMD(), InMessageHandler, InputTimeline));
 	return inputDevice;
 #endif
 }
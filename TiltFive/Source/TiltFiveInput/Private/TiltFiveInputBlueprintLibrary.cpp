@@ -15,6 +15,8 @@
 #include "TiltFiveInputBlueprintLibrary.h"
 
 #include "Framework/Application/SlateApplication.h"
+#include "HAL/PlatformTime.h"
+#include "TiltFiveInput.h"
 #include "TiltFiveKeys.h"
 
 FTiltFiveNavigationConfig::FTiltFiveNavigationConfig()
@@ -93,5 +95,21 @@ bool UTiltFiveInputBlueprintLibrary::UnregisterTiltFiveNavigation()
 	return false;
 }
 
+bool UTiltFiveInputBlueprintLibrary::GetWandButtonPressAge(int32 PlayerIndex, FKey Key, float& SecondsAgo)
+{
+	double TimeSeconds;
+	const bool bFound = FTiltFiveInputModule::Get().GetInputTimeline().GetLastPressTime(PlayerIndex, Key, TimeSeconds);
+	SecondsAgo = bFound ? FPlatformTime::Seconds() - TimeSeconds : 0.0f;
+	return bFound;
+}
+
+bool UTiltFiveInputBlueprintLibrary::GetWandButtonReleaseAge(int32 PlayerIndex, FKey Key, float& SecondsAgo)
+{
+	double TimeSeconds;
+	const bool bFound = FTiltFiveInputModule::Get().GetInputTimeline().GetLastReleaseTime(PlayerIndex, Key, TimeSeconds);
+	SecondsAgo = bFound ? FPlatformTime::Seconds() - TimeSeconds : 0.0f;
+	return bFound;
+}
+
 TSharedPtr<FNavigationConfig> UTiltFiveInputBlueprintLibrary::OriginalNavigation;
 TSharedPtr<FTiltFiveNavigationConfig> UTiltFiveInputBlueprintLibrary::TiltFiveNavigation;
@@ -17,6 +17,7 @@
 #include "DrawDebugHelpers.h"
 #include "Engine/Engine.h"
 #include "HMD/TiltFiveHMD.h"
+#include "Misc/App.h"
 #include "Misc/CoreDelegates.h"
 #if UE_VERSION_NEWER_THAN(5, 1, 0)
 #include "GenericPlatform/GenericPlatformInputDeviceMapper.h"
@@ -31,14 +32,18 @@
 #define UE_ARRAY_COUNT ARRAY_COUNT
 #endif
 
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+typedef VectorRegister VectorRegister4Float;
+#endif
+
 
 FTiltFiveInputDevice::FTiltFiveInputDevice(const TSharedPtr<FTiltFiveXRBase, ESPMode::ThreadSafe>& InHMD,
-	const TSharedRef<FGenericApplicationMessageHandler>& InMessageHandler) : HMD(InHMD)
+	const TSharedRef<FGenericApplicationMessageHandler>& InMessageHandler,
+	FTiltFiveInputTimeline& InInputTimeline) : HMD(InHMD)
 	, MessageHandler(InMessageHandler)
+	, InputTimeline(InInputTimeline)
 {
 	IModularFeatures::Get().RegisterModularFeature(GetModularFeatureName(), this);
-
-	FMemory::Memzero(WandStates, UE_ARRAY_COUNT(WandStates));
 }
 
 FTiltFiveInputDevice::~FTiltFiveInputDevice()
@@ -69,138 +74,102 @@ static const uint32 WandMasks[] = {1 << WandButtonOffsetT5,
 	1 << WandButtonOffsetA,
 	1 << WandButtonOffsetX};
 
+static bool IsValidPlayerIndex(int32 PlayerIndex)
+{
+	return PlayerIndex >= 0 && PlayerIndex < FTiltFiveWandInputState::NumPlayers;
+}
+
+// Places a wand event on the FPlatformTime::Seconds() clock. The service clock has an unknown offset to ours, which is estimated
+// from the events that reached us the quickest. The estimate is allowed to creep upwards a little with every event, so it follows
+// drift between the clocks.
+static double EstimateEventTime(FTiltFiveGlassesInputState& GlassesInputState, const FTiltFiveWandStreamEvent& QueuedEvent)
+{
+	const double ServiceSeconds = QueuedEvent.Event.timestampNanos / 1e9;
+	const double ReadSeconds = FPlatformTime::ToSeconds64(QueuedEvent.HostCycles);
+	const double Offset = ReadSeconds - ServiceSeconds;
+
+	const double MaxCreepSeconds = 1e-6;
+	if (!GlassesInputState.bHasClockOffset || Offset < GlassesInputState.ClockOffsetSeconds + MaxCreepSeconds)
+	{
+		GlassesInputState.ClockOffsetSeconds = Offset;
+		GlassesInputState.bHasClockOffset = true;
+	}
+	else
+	{
+		GlassesInputState.ClockOffsetSeconds += MaxCreepSeconds;
+	}
+
+	return ServiceSeconds + GlassesInputState.ClockOffsetSeconds;
+}
+
+// Drops whatever the wand stream reader queued. The queue has a single consumer, so only the game thread may do this.
+static void DiscardWandEvents(FTiltFiveHMD& Hmd)
+{
+	FTiltFiveWandStreamEvent QueuedEvent;
+	while (Hmd.WandEventQueue.Pop(QueuedEvent))
+	{
+	}
+}
+
 void FTiltFiveInputDevice::SendControllerEvents()
 {
+	// What the previous frame sent, to tell what changed
+	const FTiltFiveWandInputState OldInput = WandStates.Input;
+
 	for (TSharedPtr<class FTiltFiveHMD, ESPMode::ThreadSafe> Hmd : HMD->GlassesList) {
 		if (!FTiltFiveModule::Get().IsValid())
 		{
 			continue;
 		}
 
-		if (Hmd.IsValid())
+		if (!Hmd.IsValid())
 		{
-			if (!Hmd->IsHMDEnabled())
-			{
-				continue;
-			}
+			continue;
 		}
 
+		FTiltFiveGlassesInputState& GlassesInputState = GlassesInputStates[Hmd->DeviceId];
 		FT5GlassesPtr CurrentGlasses = Hmd->GetCurrentExclusiveGlasses();
 
-		// We did not establish a pair of glasses yet, so we cannot fetch input
-		if (!CurrentGlasses)
-		{
-			continue;
-		}
-
-		// Note(marvin@lab132.com): Do we need to un-configure the old glasses in case they change
-		// during runtime ?
-		if (!ConfiguredInputGlasses || CurrentGlasses != ConfiguredInputGlasses)
+		// Wand handles are only valid for the glasses they were listed for, start over whenever the glasses change. Glasses that
+		// went away end up here as well, which resets their player so its wands are reported as disconnected.
+		if (CurrentGlasses != GlassesInputState.Glasses)
 		{
-			FScopeLock ScopeLock(&Hmd->ExclusiveGroup1CriticalSection);
-
-			FT5WandStreamConfig WandStreamConfig;
-			WandStreamConfig.enabled = true;
-			const FT5Result Result = t5ConfigureWandStreamForGlasses(CurrentGlasses, &WandStreamConfig);
-			UE_CLOG(Result != T5_SUCCESS,
-				LogTiltFiveInput,
-				Error,
-				TEXT("Failed to configure wand stream for TiltFiveWand: %S"),
-				t5GetResultMessage(Result));
-			if (Result == T5_SUCCESS)
-			{
-				ConfiguredInputGlasses = CurrentGlasses;
-			}
-			else
-			{
-				ConfiguredInputGlasses = nullptr;
-			}
-		}
+			GlassesInputState = FTiltFiveGlassesInputState();
+			GlassesInputState.Glasses = CurrentGlasses;
+			WandStates.ResetPlayer(Hmd->DeviceId);
 
-		if (!ConfiguredInputGlasses)
-		{
-			return;
+			// Events of the earlier glasses would otherwise be applied to the next ones, whose wand handles may match. Wands of
+			// the new glasses are listed again, so dropping their first events as well loses no connections.
+			DiscardWandEvents(*Hmd);
 		}
 
-		FTiltFiveControllerState OldWandStates[T5_MAX_NUM_CONTROLLER];
-		for (uint32 WandIndex = 0; WandIndex < T5_MAX_NUM_CONTROLLER; ++WandIndex)
+		// Without glasses there is no input, but the reader of the last ones may still push events until it is stopped
+		if (!CurrentGlasses)
 		{
-			OldWandStates[WandIndex] = WandStates[Hmd->DeviceId][WandIndex];
+			DiscardWandEvents(*Hmd);
+			continue;
 		}
 
+		if (GlassesInputState.bWandListDirty)
 		{
-			FScopeLock ScopeLock(&Hmd->ExclusiveGroup1CriticalSection);
-
-			TArray<FT5WandHandle> ConnectedWands;
-			ConnectedWands.SetNumUninitialized(T5_MAX_NUM_CONTROLLER);
-
-			uint8 NumberOfWands = ConnectedWands.Num();
-
-			FT5Result Result = t5ListWandsForGlasses(ConfiguredInputGlasses, ConnectedWands.GetData(), &NumberOfWands);
-			// We currently (silently) drop the extra wands that may be connected, since we only support
-			// up to T5_MAX_NUM_CONTROLLER wands anyway.
-			UE_CLOG(Result != T5_SUCCESS && Result != T5_ERROR_OVERFLOW,
-				LogTiltFiveInput,
-				Warning,
-				TEXT("Failed to list wands: %S"),
-				t5GetResultMessage(Result));
-
-			ConnectedWands.SetNumUnsafeInternal(NumberOfWands);
-
-			for (uint32 WandIndex = 0; WandIndex < T5_MAX_NUM_CONTROLLER; ++WandIndex)
-			{
-				if (ConnectedWands.IsValidIndex(WandIndex))
-				{
-					WandStates[Hmd->DeviceId][WandIndex].WandHandle = ConnectedWands[WandIndex];
-					WandStates[Hmd->DeviceId][WandIndex].bConnected = true;
-				}
-				else
-				{
-					WandStates[Hmd->DeviceId][WandIndex].WandHandle.Reset();
-					WandStates[Hmd->DeviceId][WandIndex].bConnected = false;
-				}
-			}
+			ListConnectedWands(*Hmd, CurrentGlasses);
 		}
 
-		// Currently, we only support the first user to have any controller, as we don't support
-		// multiple glasses at the moment
-		const int32 ControllerIndex = Hmd->DeviceId;
-#if UE_VERSION_NEWER_THAN(5, 1, 0)
-		const FInputDeviceId deviceId = FInputDeviceId::CreateFromInternalId(ControllerIndex);
-#endif
-
-		int32 NumEvent = 0;
-		// Fail-safe to not get stuck in an infinite loop
-		const int32 MaxNumEvents = 1000;
-
-		FT5Result WandStreamResult = T5_SUCCESS;
-
-		// First of gather all events happened since last frame.
+		// Gather all events that happened since last frame first.
 		// This is necessary as the UPlayerInput does not seem to like
 		// multiple analog axis value changes per frame and gets confused
-		do
+		FTiltFiveWandStreamEvent QueuedEvent;
+		while (Hmd->WandEventQueue.Pop(QueuedEvent))
 		{
-			int32 WandIndex = INDEX_NONE;
-			FT5WandStreamEvent StreamEvent;
-
-			{
-				FScopeLock ScopeLock(&HMD->GlassesList[0]->ExclusiveGroup2CriticalSection);
+			const FT5WandStreamEvent& StreamEvent = QueuedEvent.Event;
 
-				// We don't want to spend any time waiting
-				const uint32 TimeoutMs = 0;
+			GlassesInputState.LastEventHostCycles = QueuedEvent.HostCycles;
+			const double EventTimeSeconds = EstimateEventTime(GlassesInputState, QueuedEvent);
 
-				WandStreamResult = t5ReadWandStreamForGlasses(ConfiguredInputGlasses, &StreamEvent, TimeoutMs);
-
-				UE_CLOG(WandStreamResult != T5_SUCCESS && WandStreamResult != T5_TIMEOUT,
-					LogTiltFiveInput,
-					Error,
-					TEXT("Failed to retrieve wand stream event: %S"),
-					t5GetResultMessage(WandStreamResult));
-			}
-
-			if (WandStreamResult != T5_SUCCESS)
+			// A wand we haven't seen yet, its handle only shows up in the wand list
+			if (StreamEvent.type == kT5_WandStreamEventType_Connect)
 			{
-				break;
+				ListConnectedWands(*Hmd, CurrentGlasses);
 			}
 
 			// TODO(marvin@lab132.com): What does this event supposed to mean?
@@ -209,40 +178,28 @@ void FTiltFiveInputDevice::SendControllerEvents()
 				continue;
 			}
 
-			for (int32 PotentialWandIndex = 0; PotentialWandIndex < T5_MAX_NUM_CONTROLLER; ++PotentialWandIndex)
-			{
-				if (WandStates[Hmd->DeviceId][PotentialWandIndex].WandHandle.IsSet() &&
-					WandStates[Hmd->DeviceId][PotentialWandIndex].WandHandle == StreamEvent.wandId)
-				{
-					WandIndex = PotentialWandIndex;
-					break;
-				}
-			}
-
+			const int32 WandIndex = WandStates.FindWand(Hmd->DeviceId, StreamEvent.wandId);
 			if (WandIndex == INDEX_NONE)
 			{
 				continue;
 			}
+			const int32 Slot = FTiltFiveWandStateStore::GetSlot(Hmd->DeviceId, WandIndex);
 
 			switch (StreamEvent.type)
 			{
 			case kT5_WandStreamEventType_Connect:
 			{
-				WandStates[Hmd->DeviceId][WandIndex].bConnected = true;
+				WandStates.SetConnected(Slot, true);
 			}
 			break;
 			case kT5_WandStreamEventType_Disconnect:
 			{
-				WandStates[Hmd->DeviceId][WandIndex].bConnected = false;
+				WandStates.SetConnected(Slot, false);
 			}
 			break;
 			case kT5_WandStreamEventType_Report:
 			{
-				FTiltFiveControllerState NewState;
-				FMemory::Memzero(NewState);
-
-				NewState.InitFromReport(StreamEvent.report);
-				WandStates[Hmd->DeviceId][WandIndex].UpdateFromState(NewState);
+				WandStates.ApplyReport(Slot, StreamEvent.report, EventTimeSeconds, StreamEvent.timestampNanos);
 			}
 			break;
 			default:
@@ -251,226 +208,238 @@ void FTiltFiveInputDevice::SendControllerEvents()
 			}
 			break;
 			}
-		} while (++NumEvent < MaxNumEvents);
+		}
+	}
 
-		UE_CLOG(NumEvent >= MaxNumEvents,
-			LogTiltFiveInput,
-			Warning,
-			TEXT("Throttled wand stream input, read a maximum of %d events."),
-			NumEvent);
+	const FTiltFiveAnalogSettings AnalogSettings = FTiltFiveAnalogSettings::FromProjectSettings();
 
-		for (int32 WandIndex = 0; WandIndex < T5_MAX_NUM_CONTROLLER; ++WandIndex)
-		{
-			const bool bIsRightWand = WandIndex == 0;
+	// Slots still settling are processed again even without new reports, so smoothing reaches the raw values
+	uint32 SlotsToSend = FTiltFiveWandInputState::FindSlotsToSend(OldInput, WandStates.Input, AnalogSettings.EventThreshold) |
+		WandStates.AnalogSettlingMask | WandStates.ButtonTransitionMask;
+	while (SlotsToSend != 0)
+	{
+		const int32 Slot = FMath::CountTrailingZeros(SlotsToSend);
+		SlotsToSend &= SlotsToSend - 1;
 
-			FTiltFiveControllerState& NewState = WandStates[Hmd->DeviceId][WandIndex];
-			FTiltFiveControllerState& OldState = OldWandStates[WandIndex];
+		SendWandEvents(Slot / T5_MAX_NUM_CONTROLLER, Slot % T5_MAX_NUM_CONTROLLER, OldInput, AnalogSettings);
+	}
 
-			if (NewState.bConnected != OldState.bConnected)
-			{
-				UE_CLOG(NewState.bConnected, LogTiltFiveInput, Verbose, TEXT("Wand connected with index %d"), WandIndex);
-				UE_CLOG(!NewState.bConnected, LogTiltFiveInput, Verbose, TEXT("Wand disconnected with index %d"), WandIndex);
-#if UE_VERSION_NEWER_THAN(5, 1, 0)
-				((IPlatformInputDeviceMapper::Get()).GetOnInputDeviceConnectionChange())
-					.Broadcast(NewState.bConnected ? EInputDeviceConnectionState::Connected : EInputDeviceConnectionState::Disconnected,
-						FPlatformMisc::GetPlatformUserForUserIndex(Hmd->DeviceId),
-						deviceId);
-#else
-				FCoreDelegates::OnControllerConnectionChange.Broadcast(NewState.bConnected, -1, ControllerIndex);
-#endif
-			}
+	WandStates.ButtonTransitions.Reset();
+	WandStates.ButtonTransitionMask = 0;
+}
 
-			if (OldState.HasInputChanged(NewState))
-			{
-				static const FKey WandKeysLeft[] = { ETiltFiveKeys::WandL_T5,
-					ETiltFiveKeys::WandL_One,
-					ETiltFiveKeys::WandL_Two,
-					ETiltFiveKeys::WandL_Three,
-					ETiltFiveKeys::WandL_Y,
-					ETiltFiveKeys::WandL_B,
-					ETiltFiveKeys::WandL_A,
-					ETiltFiveKeys::WandL_X };
-
-				static const FKey WandKeysRight[] = { ETiltFiveKeys::WandR_T5,
-					ETiltFiveKeys::WandR_One,
-					ETiltFiveKeys::WandR_Two,
-					ETiltFiveKeys::WandR_Three,
-					ETiltFiveKeys::WandR_Y,
-					ETiltFiveKeys::WandR_B,
-					ETiltFiveKeys::WandR_A,
-					ETiltFiveKeys::WandR_X };
-
-				const FKey* ActiveWandKeys = bIsRightWand ? WandKeysRight : WandKeysLeft;
-
-				const FKey& Wand_StickRight = bIsRightWand ? ETiltFiveKeys::WandR_StickRight : ETiltFiveKeys::WandL_StickRight;
-				const FKey& Wand_StickLeft = bIsRightWand ? ETiltFiveKeys::WandR_StickLeft : ETiltFiveKeys::WandL_StickLeft;
-				const FKey& Wand_StickUp = bIsRightWand ? ETiltFiveKeys::WandR_StickUp : ETiltFiveKeys::WandL_StickUp;
-				const FKey& Wand_StickDown = bIsRightWand ? ETiltFiveKeys::WandR_StickDown : ETiltFiveKeys::WandL_StickDown;
-				const FKey& Wand_StickX = bIsRightWand ? ETiltFiveKeys::WandR_StickX : ETiltFiveKeys::WandL_StickX;
-				const FKey& Wand_StickY = bIsRightWand ? ETiltFiveKeys::WandR_StickY : ETiltFiveKeys::WandL_StickY;
-				const FKey& Wand_Trigger = bIsRightWand ? ETiltFiveKeys::WandR_Trigger : ETiltFiveKeys::WandL_Trigger;
-				const FKey& Wand_TriggerAxis = bIsRightWand ? ETiltFiveKeys::WandR_TriggerAxis : ETiltFiveKeys::WandL_TriggerAxis;
-
-				if (NewState.Buttons.IsSet())
-				{
-					for (int32 ButtonIndex = 0; ButtonIndex < UE_ARRAY_COUNT(WandKeysLeft); ++ButtonIndex)
-					{
-						const bool bWasPressed = !!(OldState.Buttons.Get(0) & WandMasks[ButtonIndex]);
-						const bool bIsPressed = !!(NewState.Buttons.GetValue() & WandMasks[ButtonIndex]);
-						if (bWasPressed ^ bIsPressed)
-						{
-							if (bIsPressed)
-							{
-								UE_LOG(LogTiltFiveInput,
-									Verbose,
-									TEXT("%s Pressed Wand %d"),
-									*ActiveWandKeys[ButtonIndex].ToString(),
-									WandIndex);
+void FTiltFiveInputDevice::SendWandEvents(int32 PlayerIndex,
+	int32 WandIndex,
+	const FTiltFiveWandInputState& OldInput,
+	const FTiltFiveAnalogSettings& AnalogSettings)
+{
+	FTiltFiveWandInputState& NewInput = WandStates.Input;
+	const int32 Slot = FTiltFiveWandStateStore::GetSlot(PlayerIndex, WandIndex);
+	const uint32 SlotBit = FTiltFiveWandStateStore::GetSlotBit(Slot);
+
+	const int32 ControllerIndex = PlayerIndex;
 #if UE_VERSION_NEWER_THAN(5, 1, 0)
-								MessageHandler->OnControllerButtonPressed(ActiveWandKeys[ButtonIndex].GetFName(),
-									FPlatformMisc::GetPlatformUserForUserIndex(Hmd->DeviceId),
-									deviceId,
-									false);
-#else
-								MessageHandler->OnControllerButtonPressed(
-									ActiveWandKeys[ButtonIndex].GetFName(), ControllerIndex, false);
+	const FInputDeviceId deviceId = FInputDeviceId::CreateFromInternalId(ControllerIndex);
 #endif
-							}
-							else
-							{
-								UE_LOG(LogTiltFiveInput,
-									Verbose,
-									TEXT("%s Released Wand %d"),
-									*ActiveWandKeys[ButtonIndex].ToString(),
-									WandIndex);
+
+	const bool bIsRightWand = WandIndex == 0;
+
+	const bool bWasConnected = (OldInput.ConnectedMask & SlotBit) != 0;
+	const bool bIsConnected = (NewInput.ConnectedMask & SlotBit) != 0;
+	if (bIsConnected != bWasConnected)
+	{
+		UE_CLOG(bIsConnected, LogTiltFiveInput, Verbose, TEXT("Wand connected with index %d"), WandIndex);
+		UE_CLOG(!bIsConnected, LogTiltFiveInput, Verbose, TEXT("Wand disconnected with index %d"), WandIndex);
 #if UE_VERSION_NEWER_THAN(5, 1, 0)
-								MessageHandler->OnControllerButtonReleased(ActiveWandKeys[ButtonIndex].GetFName(),
-									FPlatformMisc::GetPlatformUserForUserIndex(Hmd->DeviceId),
-									deviceId,
-									false);
+		((IPlatformInputDeviceMapper::Get()).GetOnInputDeviceConnectionChange())
+			.Broadcast(bIsConnected ? EInputDeviceConnectionState::Connected : EInputDeviceConnectionState::Disconnected,
+				FPlatformMisc::GetPlatformUserForUserIndex(PlayerIndex),
+				deviceId);
 #else
-								MessageHandler->OnControllerButtonReleased(
-									ActiveWandKeys[ButtonIndex].GetFName(), ControllerIndex, false);
+		FCoreDelegates::OnControllerConnectionChange.Broadcast(bIsConnected, -1, ControllerIndex);
 #endif
-							}
-						}
-					}
-				}
-				const float AxisEpsilon = 1e-3f;
-				const float AxisDeadZone = 0.15f;
-				const float AxisButtonTriggerThreshold = 0.3f;
-				const float TriggerButtonTriggerThreshold = 0.5f;
-				const float TriggerEpsilon = 1e-3f;
-				const float TriggerDeadZone = 0.07f;
-
-				if (NewState.Stick.IsSet())
-				{
-					SendAxisKeysEvent(OldState.Stick.Get(FVector2D::ZeroVector).X,
-						NewState.Stick->X,
-						true,
-						Wand_StickRight,
-						AxisButtonTriggerThreshold,
-						ControllerIndex);
-					SendAxisKeysEvent(OldState.Stick.Get(FVector2D::ZeroVector).X,
-						NewState.Stick->X,
-						false,
-						Wand_StickLeft,
-						AxisButtonTriggerThreshold,
-						ControllerIndex);
-					SendAxisKeysEvent(OldState.Stick.Get(FVector2D::ZeroVector).Y,
-						NewState.Stick->Y,
-						true,
-						Wand_StickUp,
-						AxisButtonTriggerThreshold,
-						ControllerIndex);
-					SendAxisKeysEvent(OldState.Stick.Get(FVector2D::ZeroVector).Y,
-						NewState.Stick->Y,
-						false,
-						Wand_StickDown,
-						AxisButtonTriggerThreshold,
-						ControllerIndex);
-
-					if (FMath::Abs(NewState.Stick->X) < AxisDeadZone)
-					{
-						NewState.Stick->X = 0.0f;
-					}
-					if (FMath::Abs(NewState.Stick->Y) < AxisDeadZone)
-					{
-						NewState.Stick->Y = 0.0f;
-					}
-
-					if (!FMath::IsNearlyEqual(OldState.Stick.Get(FVector2D::ZeroVector).X, NewState.Stick->X, AxisEpsilon) ||
-						FMath::Abs(NewState.Stick->X) > 0.0f)
-					{
-						UE_LOG(LogTiltFiveInput,
-							VeryVerbose,
-							TEXT("%s Analog Value Changed: %s Wand %d"),
-							*Wand_StickX.ToString(),
-							*LexToSanitizedString(NewState.Stick->X),
-							WandIndex);
+	}
+
+	static const FKey WandKeysLeft[] = { ETiltFiveKeys::WandL_T5,
+		ETiltFiveKeys::WandL_One,
+		ETiltFiveKeys::WandL_Two,
+		ETiltFiveKeys::WandL_Three,
+		ETiltFiveKeys::WandL_Y,
+		ETiltFiveKeys::WandL_B,
+		ETiltFiveKeys::WandL_A,
+		ETiltFiveKeys::WandL_X };
+
+	static const FKey WandKeysRight[] = { ETiltFiveKeys::WandR_T5,
+		ETiltFiveKeys::WandR_One,
+		ETiltFiveKeys::WandR_Two,
+		ETiltFiveKeys::WandR_Three,
+		ETiltFiveKeys::WandR_Y,
+		ETiltFiveKeys::WandR_B,
+		ETiltFiveKeys::WandR_A,
+		ETiltFiveKeys::WandR_X };
+
+	const FKey* ActiveWandKeys = bIsRightWand ? WandKeysRight : WandKeysLeft;
+
+	const FKey& Wand_StickRight = bIsRightWand ? ETiltFiveKeys::WandR_StickRight : ETiltFiveKeys::WandL_StickRight;
+	const FKey& Wand_StickLeft = bIsRightWand ? ETiltFiveKeys::WandR_StickLeft : ETiltFiveKeys::WandL_StickLeft;
+	const FKey& Wand_StickUp = bIsRightWand ? ETiltFiveKeys::WandR_StickUp : ETiltFiveKeys::WandL_StickUp;
+	const FKey& Wand_StickDown = bIsRightWand ? ETiltFiveKeys::WandR_StickDown : ETiltFiveKeys::WandL_StickDown;
+	const FKey& Wand_StickX = bIsRightWand ? ETiltFiveKeys::WandR_StickX : ETiltFiveKeys::WandL_StickX;
+	const FKey& Wand_StickY = bIsRightWand ? ETiltFiveKeys::WandR_StickY : ETiltFiveKeys::WandL_StickY;
+	const FKey& Wand_Trigger = bIsRightWand ? ETiltFiveKeys::WandR_Trigger : ETiltFiveKeys::WandL_Trigger;
+	const FKey& Wand_TriggerAxis = bIsRightWand ? ETiltFiveKeys::WandR_TriggerAxis : ETiltFiveKeys::WandL_TriggerAxis;
+
+	// Replays the button changes of the wand one report at a time, so short presses aren't lost to the frame rate
+	uint8 SentButtons = OldInput.Buttons[Slot];
+	auto SendButtonChanges = [&](uint8 Buttons, double TimeSeconds, uint64 TimestampNanos)
+	{
+		const uint32 ChangedButtons = SentButtons ^ Buttons;
+		for (int32 ButtonIndex = 0; ButtonIndex < UE_ARRAY_COUNT(WandKeysLeft); ++ButtonIndex)
+		{
+			if (!(ChangedButtons & WandMasks[ButtonIndex]))
+			{
+				continue;
+			}
+
+			const FKey& Key = ActiveWandKeys[ButtonIndex];
+			const bool bIsPressed = !!(Buttons & WandMasks[ButtonIndex]);
+			if (bIsPressed)
+			{
+				UE_LOG(LogTiltFiveInput, Verbose, TEXT("%s Pressed Wand %d"), *Key.ToString(), WandIndex);
 #if UE_VERSION_NEWER_THAN(5, 1, 0)
-						MessageHandler->OnControllerAnalog(
-							Wand_StickX.GetFName(), FPlatformMisc::GetPlatformUserForUserIndex(Hmd->DeviceId), deviceId, NewState.Stick->X);
+				MessageHandler->OnControllerButtonPressed(
+					Key.GetFName(), FPlatformMisc::GetPlatformUserForUserIndex(PlayerIndex), deviceId, false);
 #else
-						MessageHandler->OnControllerAnalog(Wand_StickX.GetFName(), ControllerIndex, NewState.Stick->X);
+				MessageHandler->OnControllerButtonPressed(Key.GetFName(), ControllerIndex, false);
 #endif
-					}
-					if (!FMath::IsNearlyEqual(OldState.Stick.Get(FVector2D::ZeroVector).Y, NewState.Stick->Y, AxisEpsilon) ||
-						FMath::Abs(NewState.Stick->Y) > 0.0f)
-					{
-						UE_LOG(LogTiltFiveInput,
-							VeryVerbose,
-							TEXT("%s Analog Value Changed: %s Wand %d"),
-							*Wand_StickY.ToString(),
-							*LexToSanitizedString(NewState.Stick->Y),
-							WandIndex);
+			}
+			else
+			{
+				UE_LOG(LogTiltFiveInput, Verbose, TEXT("%s Released Wand %d"), *Key.ToString(), WandIndex);
 #if UE_VERSION_NEWER_THAN(5, 1, 0)
-						MessageHandler->OnControllerAnalog(
-							Wand_StickY.GetFName(), FPlatformMisc::GetPlatformUserForUserIndex(Hmd->DeviceId), deviceId, NewState.Stick->Y);
+				MessageHandler->OnControllerButtonReleased(
+					Key.GetFName(), FPlatformMisc::GetPlatformUserForUserIndex(PlayerIndex), deviceId, false);
 #else
-						MessageHandler->OnControllerAnalog(Wand_StickY.GetFName(), ControllerIndex, NewState.Stick->Y);
+				MessageHandler->OnControllerButtonReleased(Key.GetFName(), ControllerIndex, false);
 #endif
-					}
-				}
-				if (NewState.Trigger.IsSet())
-				{
-					SendAxisKeysEvent(OldState.Trigger.Get(0.0f),
-						NewState.Trigger.GetValue(),
-						true,
-						Wand_Trigger,
-						TriggerButtonTriggerThreshold,
-						ControllerIndex);
-
-					if (FMath::Abs(NewState.Trigger.GetValue()) < TriggerDeadZone)
-					{
-						NewState.Trigger = 0.0f;
-					}
-
-					if (OldState.Trigger.IsSet()) 
-					{
-						if (!FMath::IsNearlyEqual(OldState.Trigger.Get(0.0f), NewState.Trigger.GetValue(), TriggerEpsilon) ||
-							FMath::Abs(NewState.Trigger.GetValue()) > 0.0f)
-						{
-							UE_LOG(LogTiltFiveInput,
-								VeryVerbose,
-								TEXT("%s Analog Value Changed: %s Wand %d"),
-								*Wand_TriggerAxis.ToString(),
-								*LexToSanitizedString(NewState.Trigger.GetValue()),
-								WandIndex);
+			}
+
+			FTiltFiveButtonEdge Edge;
+			Edge.PlayerIndex = PlayerIndex;
+			Edge.Key = Key;
+			Edge.bPressed = bIsPressed;
+			Edge.TimeSeconds = TimeSeconds;
+			Edge.TimestampNanos = TimestampNanos;
+			InputTimeline.Add(Edge);
+		}
+		SentButtons = Buttons;
+	};
+
+	if (WandStates.ButtonTransitionMask & SlotBit)
+	{
+		for (const FTiltFiveWandButtonTransition& Transition : WandStates.ButtonTransitions)
+		{
+			if (Transition.Slot == Slot)
+			{
+				SendButtonChanges(Transition.Buttons, Transition.TimeSeconds, Transition.TimestampNanos);
+			}
+		}
+	}
+
+	// Anything that didn't come from a report, e.g. buttons released because the glasses went away
+	SendButtonChanges(NewInput.Buttons[Slot], FPlatformTime::Seconds(), 0);
+
+	const float AxisButtonTriggerThreshold = 0.3f;
+	const float TriggerButtonTriggerThreshold = 0.5f;
+
+	FTiltFiveAnalogState& AnalogState = WandStates.AnalogStates[Slot];
+	const FVector2D OldStick = AnalogState.Stick;
+	const float OldTrigger = AnalogState.Trigger;
+
+	if (NewInput.AnalogValidMask & SlotBit)
+	{
+		const bool bSettling = AnalogState.Process(AnalogSettings,
+			FVector2D(NewInput.Analog[Slot][0], NewInput.Analog[Slot][1]),
+			NewInput.Analog[Slot][2],
+			FApp::GetDeltaTime());
+		WandStates.AnalogSettlingMask =
+			bSettling ? (WandStates.AnalogSettlingMask | SlotBit) : (WandStates.AnalogSettlingMask & ~SlotBit);
+	}
+	else
+	{
+		// Without analog input, e.g. after the glasses went away, the stick and trigger snap to rest. That releases stick and trigger
+		// keys that are still held, and returns the axes to zero.
+		AnalogState.Stick = FVector2D::ZeroVector;
+		AnalogState.Trigger = 0.0f;
+		WandStates.AnalogSettlingMask &= ~SlotBit;
+	}
+
+	SendAxisKeysEvent(OldStick.X, AnalogState.Stick.X, true, Wand_StickRight, AxisButtonTriggerThreshold, ControllerIndex);
+	SendAxisKeysEvent(OldStick.X, AnalogState.Stick.X, false, Wand_StickLeft, AxisButtonTriggerThreshold, ControllerIndex);
+	SendAxisKeysEvent(OldStick.Y, AnalogState.Stick.Y, true, Wand_StickUp, AxisButtonTriggerThreshold, ControllerIndex);
+	SendAxisKeysEvent(OldStick.Y, AnalogState.Stick.Y, false, Wand_StickDown, AxisButtonTriggerThreshold, ControllerIndex);
+	SendAxisKeysEvent(OldTrigger, AnalogState.Trigger, true, Wand_Trigger, TriggerButtonTriggerThreshold, ControllerIndex);
+
+	// The input system keeps the last value of an axis, so only changes are sent. Returning to rest is always sent, so an axis can't
+	// get stuck slightly off zero.
+	auto SendAnalog = [&](const FKey& Key, float Value, float& SentValue)
+	{
+		if (FMath::Abs(Value - SentValue) <= AnalogSettings.EventThreshold && (Value != 0.0f || SentValue == 0.0f))
+		{
+			return;
+		}
+
+		UE_LOG(LogTiltFiveInput,
+			VeryVerbose,
+			TEXT("%s Analog Value Changed: %s Wand %d"),
+			*Key.ToString(),
+			*LexToSanitizedString(Value),
+			WandIndex);
 #if UE_VERSION_NEWER_THAN(5, 1, 0)
-							MessageHandler->OnControllerAnalog(Wand_TriggerAxis.GetFName(),
-								FPlatformMisc::GetPlatformUserForUserIndex(Hmd->DeviceId),
-								deviceId,
-								NewState.Trigger.GetValue());
+		MessageHandler->OnControllerAnalog(Key.GetFName(), FPlatformMisc::GetPlatformUserForUserIndex(PlayerIndex), deviceId, Value);
 #else
-							MessageHandler->OnControllerAnalog(Wand_TriggerAxis.GetFName(), ControllerIndex, NewState.Trigger.GetValue());
+		MessageHandler->OnControllerAnalog(Key.GetFName(), ControllerIndex, Value);
 #endif
-						}
-					}
-				}
-			}
-		}
+		SentValue = Value;
+	};
+
+	SendAnalog(Wand_StickX, AnalogState.Stick.X, AnalogState.SentStick.X);
+	SendAnalog(Wand_StickY, AnalogState.Stick.Y, AnalogState.SentStick.Y);
+	SendAnalog(Wand_TriggerAxis, AnalogState.Trigger, AnalogState.SentTrigger);
+}
+
+void FTiltFiveInputDevice::ListConnectedWands(const FTiltFiveHMD& Hmd, FT5GlassesPtr Glasses)
+{
+	FScopeLock ScopeLock(&Hmd.ExclusiveGroup1CriticalSection);
+
+	FT5WandHandle ConnectedWands[T5_MAX_NUM_CONTROLLER];
+	uint8 NumberOfWands = T5_MAX_NUM_CONTROLLER;
+
+	FT5Result Result = t5ListWandsForGlasses(Glasses, ConnectedWands, &NumberOfWands);
+	// We currently (silently) drop the extra wands that may be connected, since we only support
+	// up to T5_MAX_NUM_CONTROLLER wands anyway.
+	UE_CLOG(Result != T5_SUCCESS && Result != T5_ERROR_OVERFLOW,
+		LogTiltFiveInput,
+		Warning,
+		TEXT("Failed to list wands: %S"),
+		t5GetResultMessage(Result));
+
+	if (Result != T5_SUCCESS && Result != T5_ERROR_OVERFLOW)
+	{
+		// Try again next frame
+		return;
+	}
+	NumberOfWands = FMath::Min<uint8>(NumberOfWands, T5_MAX_NUM_CONTROLLER);
+
+	for (uint32 WandIndex = 0; WandIndex < T5_MAX_NUM_CONTROLLER; ++WandIndex)
+	{
+		const int32 Slot = FTiltFiveWandStateStore::GetSlot(Hmd.DeviceId, WandIndex);
+		const bool bListed = WandIndex < NumberOfWands;
+		WandStates.SetHandle(Slot, bListed ? TOptional<FT5WandHandle>(ConnectedWands[WandIndex]) : TOptional<FT5WandHandle>());
+		WandStates.SetConnected(Slot, bListed);
 	}
+
+	GlassesInputStates[Hmd.DeviceId].bWandListDirty = false;
 }
 
 void FTiltFiveInputDevice::SetMessageHandler(const TSharedRef<FGenericApplicationMessageHandler>& InMessageHandler)
@@ -485,25 +454,78 @@ bool FTiltFiveInputDevice::Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice
 
 void FTiltFiveInputDevice::SetChannelValue(int32 ControllerId, FForceFeedbackChannelType ChannelType, float Value)
 {
+	if (!IsValidPlayerIndex(ControllerId))
+	{
+		return;
+	}
+
+	FForceFeedbackValues& Values = ForceFeedbackValues[ControllerId];
+	switch (ChannelType)
+	{
+	case FForceFeedbackChannelType::LEFT_LARGE:
+		Values.LeftLarge = Value;
+		break;
+	case FForceFeedbackChannelType::LEFT_SMALL:
+		Values.LeftSmall = Value;
+		break;
+	case FForceFeedbackChannelType::RIGHT_LARGE:
+		Values.RightLarge = Value;
+		break;
+	case FForceFeedbackChannelType::RIGHT_SMALL:
+		Values.RightSmall = Value;
+		break;
+	}
+	SendForceFeedback(ControllerId);
 }
 
 void FTiltFiveInputDevice::SetChannelValues(int32 ControllerId, const FForceFeedbackValues& values)
 {
+	if (!IsValidPlayerIndex(ControllerId))
+	{
+		return;
+	}
+
+	ForceFeedbackValues[ControllerId] = values;
+	SendForceFeedback(ControllerId);
+}
+
+void FTiltFiveInputDevice::SendForceFeedback(int32 PlayerIndex)
+{
+	// Force feedback is set every frame while it plays, but impulses have a fixed length. Make them long enough to bridge a few
+	// frames, the haptics sender merges the overlap.
+	const uint32 ForceFeedbackImpulseMilliseconds = 100;
+
+	const FForceFeedbackValues& Values = ForceFeedbackValues[PlayerIndex];
+	RequestImpulse(PlayerIndex, 0, FMath::Max(Values.RightLarge, Values.RightSmall), ForceFeedbackImpulseMilliseconds);
+	RequestImpulse(PlayerIndex, 1, FMath::Max(Values.LeftLarge, Values.LeftSmall), ForceFeedbackImpulseMilliseconds);
+}
+
+void FTiltFiveInputDevice::RequestImpulse(int32 PlayerIndex, int32 WandIndex, float Amplitude, uint32 DurationMilliseconds)
+{
+	const int32 Slot = FTiltFiveWandStateStore::GetSlot(PlayerIndex, WandIndex);
+	if (Amplitude <= 0.0f || !WandStates.HasHandle(Slot) || !HMD->GlassesList.IsValidIndex(PlayerIndex) ||
+		!HMD->GlassesList[PlayerIndex].IsValid())
+	{
+		return;
+	}
+
+	HMD->GlassesList[PlayerIndex]->HapticsQueue.Request(WandStates.Handles[Slot], Amplitude, DurationMilliseconds);
 }
 
 ETrackingStatus FTiltFiveInputDevice::GetControllerTrackingStatus(const int32 ControllerIndex,
 	const FName MotionSource
 ) const
 {
-	if (MotionSource == FName("Right") || MotionSource == FName("Left"))
+	if ((MotionSource == FName("Right") || MotionSource == FName("Left")) && IsValidPlayerIndex(ControllerIndex))
 	{
 		if (FTiltFiveModule::Get().IsValid())
 		{
 			// TODO(marvin@lab132.com): Can we detect if the wand is currently actively tracked (not
 			// just available, but actively seen by the glasses?)
 			const int32 WandIndex = MotionSource == FName("Right") ? 0 : 1;
-			const bool bWandAvailable = WandStates[ControllerIndex][WandIndex].WandHandle.IsSet() && WandStates[ControllerIndex][WandIndex].bConnected;
-			const bool bPoseAvailable = WandStates[ControllerIndex][WandIndex].WandPose.IsSet();
+			const int32 Slot = FTiltFiveWandStateStore::GetSlot(ControllerIndex, WandIndex);
+			const bool bWandAvailable = WandStates.HasHandle(Slot) && WandStates.IsConnected(Slot);
+			const bool bPoseAvailable = WandStates.HasPose(Slot);
 			// NOTE(marvin@lab132.com): Not entirely sure where to use InertialOnly and Tracked
 			// status, from other usages it seems like InertialOnly is used, when the device in in
 			// principle tracked but currently not visible to any trackers or so
@@ -520,20 +542,25 @@ bool FTiltFiveInputDevice::GetControllerOrientationAndPosition(const int32 Contr
 	FVector& OutPosition,
 	float WorldToMetersScale) const
 {
-	if (MotionSource == FName("Right") || MotionSource == FName("Left"))
+	if ((MotionSource == FName("Right") || MotionSource == FName("Left")) && IsValidPlayerIndex(ControllerIndex))
 	{
 		if (FTiltFiveModule::Get().IsValid())
 		{
 			bool bWandAvailable = false;
 			const int32 WandIndex = MotionSource == FName("Right") ? 0 : 1;
+			const int32 Slot = FTiltFiveWandStateStore::GetSlot(ControllerIndex, WandIndex);
 
-			// TODO(marvin@lab132.com): We should try to fetch the latest position from the wand
-			// stream here to reduce the wand latency However, due to the wand stream setup, we
-			// would also need to cache and handle all other button events and send them later on on
-			// the game thread
-			if (WandStates[ControllerIndex][WandIndex].bConnected && WandStates[ControllerIndex][WandIndex].WandPose)
+			if (WandStates.IsConnected(Slot) && WandStates.HasPose(Slot))
 			{
-				const FTiltFiveWandPose& WandPose = WandStates[ControllerIndex][WandIndex].WandPose.GetValue();
+				FTiltFiveWandPose WandPose = WandStates.Poses[Slot];
+
+				// Motion controller late updates ask from the render thread, which gets the newest pose from the wand stream
+				// instead of the one the game thread drained at the start of the frame
+				if (IsInRenderingThread() && WandStates.HasHandle(Slot) && HMD->GlassesList.IsValidIndex(ControllerIndex))
+				{
+					HMD->GlassesList[ControllerIndex]->PredictWandPose_RenderThread(
+						WandStates.Handles[Slot], WandPose.Rotation, WandPose.Position);
+				}
 
 				const FQuat WandOrientation_WorldSpace = WandPose.Rotation * FQuat(FVector::RightVector, PI);
 				const FVector WandPosition_WorldSpace = WandPose.Position * WorldToMetersScale;
@@ -563,13 +590,14 @@ ETrackingStatus FTiltFiveInputDevice::GetControllerTrackingStatus(const int32 Co
 	const EControllerHand DeviceHand
 ) const
 {
-	if (DeviceHand == EControllerHand::Right || DeviceHand == EControllerHand::Left)
+	if ((DeviceHand == EControllerHand::Right || DeviceHand == EControllerHand::Left) && IsValidPlayerIndex(ControllerIndex))
 	{
 		if (FTiltFiveModule::Get().IsValid())
 		{
 			const int32 WandIndex = DeviceHand == EControllerHand::Right ? 0 : 1;
-			const bool bWandAvailable = WandStates[WandIndex].WandHandle.IsSet() && WandStates[WandIndex].bConnected;
-			const bool bPoseAvailable = WandStates[WandIndex].WandPose.IsSet();
+			const int32 Slot = FTiltFiveWandStateStore::GetSlot(ControllerIndex, WandIndex);
+			const bool bWandAvailable = WandStates.HasHandle(Slot) && WandStates.IsConnected(Slot);
+			const bool bPoseAvailable = WandStates.HasPose(Slot);
 			return bWandAvailable ? (bPoseAvailable ? ETrackingStatus::Tracked : ETrackingStatus::InertialOnly)
 				: ETrackingStatus::NotTracked;
 		}
@@ -583,39 +611,10 @@ bool FTiltFiveInputDevice::GetControllerOrientationAndPosition(const int32 Contr
 	FVector& OutPosition,
 	float WorldToMetersScale) const
 {
-	if (ControllerIndex != 0)
-	{
-		return false;
-	}
-	if (DeviceHand == EControllerHand::Right || DeviceHand == EControllerHand::Left)
+	if ((DeviceHand == EControllerHand::Right || DeviceHand == EControllerHand::Left) && IsValidPlayerIndex(ControllerIndex))
 	{
-		if (FTiltFiveModule::Get().IsValid())
-		{
-			bool bWandAvailable = false;
-			const int32 WandIndex = DeviceHand == EControllerHand::Right ? 0 : 1;
-
-			if (WandStates[WandIndex].bConnected && WandStates[WandIndex].WandPose)
-			{
-				const FTiltFiveWandPose& WandPose = WandStates[WandIndex].WandPose.GetValue();
-
-				const FQuat WandOrientation_WorldSpace = WandPose.Rotation * FQuat(FVector::RightVector, PI);
-				const FVector WandPosition_WorldSpace = WandPose.Position * WorldToMetersScale;
-				if (WandOrientation_WorldSpace.ContainsNaN() || WandPosition_WorldSpace.ContainsNaN())
-				{
-					UE_LOG(LogTiltFiveInput, VeryVerbose, TEXT("Got NaN in a Wand Position!"));
-
-					return false;
-				}
-				OutPosition = WandPosition_WorldSpace;
-				OutOrientation = WandOrientation_WorldSpace.Rotator();
-				return true;
-			}
-		}
-		else
-		{
-			UE_LOG(LogTiltFiveInput, VeryVerbose, TEXT("Tilt Five Module not available"));
-		}
-		return false;
+		const FName MotionSource = DeviceHand == EControllerHand::Right ? FName("Right") : FName("Left");
+		return GetControllerOrientationAndPosition(ControllerIndex, MotionSource, OutOrientation, OutPosition, WorldToMetersScale);
 	}
 	return false;
 }
@@ -623,10 +622,53 @@ bool FTiltFiveInputDevice::GetControllerOrientationAndPosition(const int32 Contr
 
 #if UE_VERSION_NEWER_THAN(5, 2, 0)
 bool FTiltFiveInputDevice::GetControllerOrientationAndPosition(const int32 ControllerIndex, const FName MotionSource, FRotator& OutOrientation, FVector& OutPosition, bool& OutbProvidedLinearVelocity, FVector& OutLinearVelocity, bool& OutbProvidedAngularVelocity, FVector& OutAngularVelocityAsAxisAndLength, bool& OutbProvidedLinearAcceleration, FVector& OutLinearAcceleration, float WorldToMetersScale) const {
-	return GetControllerOrientationAndPosition(ControllerIndex, MotionSource, OutOrientation, OutPosition, WorldToMetersScale);
+	OutbProvidedLinearVelocity = false;
+	OutbProvidedAngularVelocity = false;
+	OutbProvidedLinearAcceleration = false;
+
+	if (!GetControllerOrientationAndPosition(ControllerIndex, MotionSource, OutOrientation, OutPosition, WorldToMetersScale))
+	{
+		return false;
+	}
+
+	// The pose stays the one the game (or render) thread sees, the velocities are those of the wand right now
+	FTiltFiveWandMotion WandMotion;
+	if (SampleWandMotion(ControllerIndex, MotionSource, FPlatformTime::Seconds(), WandMotion))
+	{
+		OutbProvidedLinearVelocity = true;
+		OutLinearVelocity = WandMotion.LinearVelocity * WorldToMetersScale;
+		OutbProvidedAngularVelocity = true;
+		OutAngularVelocityAsAxisAndLength = WandMotion.AngularVelocity;
+	}
+	return true;
 }
 bool FTiltFiveInputDevice::GetControllerOrientationAndPositionForTime(const int32 ControllerIndex, const FName MotionSource, FTimespan Time, bool& OutTimeWasUsed, FRotator& OutOrientation, FVector& OutPosition, bool& OutbProvidedLinearVelocity, FVector& OutLinearVelocity, bool& OutbProvidedAngularVelocity, FVector& OutAngularVelocityAsAxisAndLength, bool& OutbProvidedLinearAcceleration, FVector& OutLinearAcceleration, float WorldToMetersScale) const {
-	return GetControllerOrientationAndPosition(ControllerIndex, MotionSource, OutOrientation, OutPosition, WorldToMetersScale);
+	OutbProvidedLinearAcceleration = false;
+
+	FTiltFiveWandMotion WandMotion;
+	if (!SampleWandMotion(ControllerIndex, MotionSource, Time.GetTotalSeconds(), WandMotion))
+	{
+		OutTimeWasUsed = false;
+		return GetControllerOrientationAndPosition(ControllerIndex, MotionSource, OutOrientation, OutPosition, OutbProvidedLinearVelocity, OutLinearVelocity, OutbProvidedAngularVelocity, OutAngularVelocityAsAxisAndLength, OutbProvidedLinearAcceleration, OutLinearAcceleration, WorldToMetersScale);
+	}
+
+	const FQuat WandOrientation_WorldSpace = WandMotion.Orientation * FQuat(FVector::RightVector, PI);
+	const FVector WandPosition_WorldSpace = WandMotion.Position * WorldToMetersScale;
+	if (WandOrientation_WorldSpace.ContainsNaN() || WandPosition_WorldSpace.ContainsNaN())
+	{
+		UE_LOG(LogTiltFiveInput, VeryVerbose, TEXT("Got NaN in a Wand Position!"));
+		OutTimeWasUsed = false;
+		return false;
+	}
+
+	OutTimeWasUsed = true;
+	OutOrientation = WandOrientation_WorldSpace.Rotator();
+	OutPosition = WandPosition_WorldSpace;
+	OutbProvidedLinearVelocity = true;
+	OutLinearVelocity = WandMotion.LinearVelocity * WorldToMetersScale;
+	OutbProvidedAngularVelocity = true;
+	OutAngularVelocityAsAxisAndLength = WandMotion.AngularVelocity;
+	return true;
 }
 
 void FTiltFiveInputDevice::EnumerateSources(TArray<FMotionControllerSource>& SourcesOut) const {
@@ -634,6 +676,28 @@ void FTiltFiveInputDevice::EnumerateSources(TArray<FMotionControllerSource>& Sou
 }
 #endif
 
+bool FTiltFiveInputDevice::SampleWandMotion(
+	const int32 ControllerIndex, const FName MotionSource, double TimeSeconds, FTiltFiveWandMotion& OutMotion) const
+{
+	if (MotionSource != FName("Right") && MotionSource != FName("Left"))
+	{
+		return false;
+	}
+	if (!FTiltFiveModule::Get().IsValid() || !IsValidPlayerIndex(ControllerIndex) || !HMD->GlassesList.IsValidIndex(ControllerIndex))
+	{
+		return false;
+	}
+
+	const int32 WandIndex = MotionSource == FName("Right") ? 0 : 1;
+	const int32 Slot = FTiltFiveWandStateStore::GetSlot(ControllerIndex, WandIndex);
+	if (!WandStates.IsConnected(Slot) || !WandStates.HasHandle(Slot))
+	{
+		return false;
+	}
+
+	return HMD->GlassesList[ControllerIndex]->SampleWandMotion(WandStates.Handles[Slot], TimeSeconds, OutMotion);
+}
+
 const FName TiltFiveWandName("TiltFiveWand");
 
 FName FTiltFiveInputDevice::GetMotionControllerDeviceTypeName() const
@@ -643,15 +707,16 @@ FName FTiltFiveInputDevice::GetMotionControllerDeviceTypeName() const
 
 void FTiltFiveInputDevice::SetHapticFeedbackValues(int32 ControllerId, int32 Hand, const FHapticFeedbackValues& Values)
 {
-	if (ControllerId < 4 && ControllerId >=0) {
-		if (Hand < 2 && Hand >= 0) {
-			if (HMD->GlassesList[ControllerId]->CurrentExclusiveGlasses) {
-				if (WandStates[ControllerId][Hand].WandHandle.IsSet()) {
-					t5SendImpulse(HMD->GlassesList[ControllerId]->CurrentExclusiveGlasses, WandStates[ControllerId][Hand].WandHandle.GetValue(), Values.Amplitude, Values.Frequency);
-				}
-			}
-		}
+	if (!IsValidPlayerIndex(ControllerId) ||
+		(Hand != (int32)EControllerHand::Left && Hand != (int32)EControllerHand::Right))
+	{
+		return;
 	}
+
+	// The frequency range we report is the range of impulse durations in seconds, the wands have no frequency control
+	const int32 WandIndex = Hand == (int32)EControllerHand::Right ? 0 : 1;
+	const uint32 DurationMilliseconds = FMath::Clamp(FMath::RoundToInt(Values.Frequency * 1000.0f), 0, 320);
+	RequestImpulse(ControllerId, WandIndex, Values.Amplitude, DurationMilliseconds);
 }
 
 void FTiltFiveInputDevice::GetHapticFrequencyRange(float& MinFrequency, float& MaxFrequency) const
@@ -710,23 +775,90 @@ void FTiltFiveInputDevice::SendAxisKeysEvent(float OldValue,
 	}
 }
 
-bool FTiltFiveControllerState::HasInputChanged(const FTiltFiveControllerState& Other) const
+uint32 FTiltFiveWandInputState::FindSlotsToSend(const FTiltFiveWandInputState& Old, const FTiltFiveWandInputState& New, float AnalogEpsilon)
+{
+	uint32 SlotsToSend = (Old.ConnectedMask ^ New.ConnectedMask) | (Old.ButtonsValidMask ^ New.ButtonsValidMask) |
+		(Old.AnalogValidMask ^ New.AnalogValidMask);
+
+	const VectorRegister4Float Epsilon = VectorSetFloat1(AnalogEpsilon);
+	for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+	{
+		const VectorRegister4Float OldAnalog = VectorLoadAligned(Old.Analog[Slot]);
+		const VectorRegister4Float NewAnalog = VectorLoadAligned(New.Analog[Slot]);
+		const bool bAnalogChanged = VectorAnyGreaterThan(VectorAbs(VectorSubtract(NewAnalog, OldAnalog)), Epsilon) != 0;
+
+		if ((Old.Buttons[Slot] ^ New.Buttons[Slot]) || bAnalogChanged)
+		{
+			SlotsToSend |= FTiltFiveWandStateStore::GetSlotBit(Slot);
+		}
+	}
+
+	return SlotsToSend;
+}
+
+void FTiltFiveWandStateStore::SetConnected(int32 Slot, bool bConnected)
 {
-	return Buttons != Other.Buttons || Stick != Other.Stick || Trigger != Other.Trigger || WandPose != Other.WandPose;
+	Input.ConnectedMask = bConnected ? (Input.ConnectedMask | GetSlotBit(Slot)) : (Input.ConnectedMask & ~GetSlotBit(Slot));
 }
 
-void FTiltFiveControllerState::InitFromReport(const FT5WandReport& Report)
+void FTiltFiveWandStateStore::SetHandle(int32 Slot, const TOptional<FT5WandHandle>& Handle)
 {
+	HandleValidMask = Handle.IsSet() ? (HandleValidMask | GetSlotBit(Slot)) : (HandleValidMask & ~GetSlotBit(Slot));
+	Handles[Slot] = Handle.Get(0);
+}
+
+void FTiltFiveWandStateStore::ResetPlayer(int32 PlayerIndex)
+{
+	for (int32 WandIndex = 0; WandIndex < T5_MAX_NUM_CONTROLLER; ++WandIndex)
+	{
+		const int32 Slot = GetSlot(PlayerIndex, WandIndex);
+		const uint32 ClearBit = ~GetSlotBit(Slot);
+
+		Input.ConnectedMask &= ClearBit;
+		Input.ButtonsValidMask &= ClearBit;
+		Input.AnalogValidMask &= ClearBit;
+		Input.Buttons[Slot] = 0;
+		FMemory::Memzero(Input.Analog[Slot]);
+
+		HandleValidMask &= ClearBit;
+		Handles[Slot] = 0;
+		PoseValidMask &= ClearBit;
+		// AnalogStates are kept, SendWandEvents brings them to rest and sends the matching releases
+		AnalogSettlingMask &= ClearBit;
+		ButtonTransitionMask &= ClearBit;
+		ButtonTransitions.RemoveAll([Slot](const FTiltFiveWandButtonTransition& Transition) { return Transition.Slot == Slot; });
+	}
+}
+
+int32 FTiltFiveWandStateStore::FindWand(int32 PlayerIndex, FT5WandHandle Handle) const
+{
+	for (int32 WandIndex = 0; WandIndex < T5_MAX_NUM_CONTROLLER; ++WandIndex)
+	{
+		const int32 Slot = GetSlot(PlayerIndex, WandIndex);
+		if (HasHandle(Slot) && Handles[Slot] == Handle)
+		{
+			return WandIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+void FTiltFiveWandStateStore::ApplyReport(int32 Slot, const FT5WandReport& Report, double TimeSeconds, uint64 TimestampNanos)
+{
+	const uint32 SlotBit = GetSlotBit(Slot);
+
 	// NOTE(marvin@lab132.com): Assuming this means all float values
 	if (Report.analogValid)
 	{
-		Stick = FVector2D(Report.stick.x, Report.stick.y);
-		Trigger = Report.trigger;
+		Input.Analog[Slot][0] = Report.stick.x;
+		Input.Analog[Slot][1] = Report.stick.y;
+		Input.Analog[Slot][2] = Report.trigger;
+		Input.AnalogValidMask |= SlotBit;
 	}
 
 	if (Report.buttonsValid)
 	{
-		int32 NewButtons = 0;
+		uint8 NewButtons = 0;
 		NewButtons |= (Report.buttons.t5 ? 1 : 0) << WandButtonOffsetT5;
 		NewButtons |= (Report.buttons.one ? 1 : 0) << WandButtonOffsetOne;
 		NewButtons |= (Report.buttons.two ? 1 : 0) << WandButtonOffsetTwo;
@@ -735,33 +867,20 @@ void FTiltFiveControllerState::InitFromReport(const FT5WandReport& Report)
 		NewButtons |= (Report.buttons.b ? 1 : 0) << WandButtonOffsetB;
 		NewButtons |= (Report.buttons.a ? 1 : 0) << WandButtonOffsetA;
 		NewButtons |= (Report.buttons.x ? 1 : 0) << WandButtonOffsetX;
-		Buttons = NewButtons;
+		if (NewButtons != Input.Buttons[Slot])
+		{
+			ButtonTransitions.Add({Slot, NewButtons, TimeSeconds, TimestampNanos});
+			ButtonTransitionMask |= SlotBit;
+		}
+		Input.Buttons[Slot] = NewButtons;
+		Input.ButtonsValidMask |= SlotBit;
 	}
 
 	if (Report.poseValid)
 	{
 		// These are unrelated to any world, so do not scale them (yet)
-		WandPose = {FTiltFiveHMD::ConvertPositionFromHardware(Report.posGrip_GBD, 1.0f),
+		Poses[Slot] = {FTiltFiveHMD::ConvertPositionFromHardware(Report.posGrip_GBD, 1.0f),
 			FTiltFiveHMD::ConvertRotationFromHardware(Report.rotToWND_GBD)};
-	}
-}
-
-void FTiltFiveControllerState::UpdateFromState(const FTiltFiveControllerState& NewState)
-{
-	if (NewState.Buttons)
-	{
-		Buttons = NewState.Buttons;
-	}
-	if (NewState.Stick)
-	{
-		Stick = NewState.Stick;
-	}
-	if (NewState.Trigger)
-	{
-		Trigger = NewState.Trigger;
-	}
-	if (NewState.WandPose)
-	{
-		WandPose = NewState.WandPose;
+		PoseValidMask |= SlotBit;
 	}
 }
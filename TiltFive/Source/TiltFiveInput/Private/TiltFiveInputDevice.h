@@ -18,6 +18,8 @@
 #include "IHapticDevice.h"
 #include "IInputDevice.h"
 #include "InputCoreTypes.h"
+#include "TiltFiveAnalogProcessor.h"
+#include "TiltFiveInputTimeline.h"
 #include "TiltFiveTypes.h"
 #include "XRMotionControllerBase.h"
 #include "Misc/EngineVersionComparison.h"
@@ -35,23 +37,105 @@ struct FTiltFiveWandPose
 	}
 };
 
-struct FTiltFiveControllerState
+#define T5_MAX_NUM_CONTROLLER (2)
+
+/**
+ * Input values of every wand of every player, small enough to be copied and compared as a whole once per frame. Wands are
+ * addressed by slot, see FTiltFiveWandStateStore::GetSlot.
+ */
+struct FTiltFiveWandInputState
+{
+	static constexpr int32 NumPlayers = 4;
+	static constexpr int32 NumSlots = NumPlayers * T5_MAX_NUM_CONTROLLER;
+
+	// One bit per slot
+	uint32 ConnectedMask = 0;
+	uint32 ButtonsValidMask = 0;
+	uint32 AnalogValidMask = 0;
+
+	// Pressed buttons of every slot, one bit per button. Zero while not valid.
+	uint8 Buttons[NumSlots] = {};
+
+	// Stick X, stick Y and trigger of every slot, padded to four floats so a slot compares as one vector. Zero while not valid.
+	alignas(16) float Analog[NumSlots][4] = {};
+
+	/**
+	 * Returns a mask of the slots that have to send input events: their connection, validity or buttons changed, or one of their
+	 * raw analog values moved by more than AnalogEpsilon.
+	 */
+	static uint32 FindSlotsToSend(const FTiltFiveWandInputState& Old, const FTiltFiveWandInputState& New, float AnalogEpsilon);
+};
+
+/** The buttons of a wand after one of its reports changed them. */
+struct FTiltFiveWandButtonTransition
 {
-	bool bConnected;
-	TOptional<uint32> Buttons;
-	TOptional<FVector2D> Stick;
-	TOptional<float> Trigger;
+	int32 Slot;
+	uint8 Buttons;
+
+	// When the wand reported the change, see FTiltFiveButtonEdge
+	double TimeSeconds;
+	uint64 TimestampNanos;
+};
+
+/** Everything known about the wands of all players, stored by field rather than by wand. */
+struct FTiltFiveWandStateStore
+{
+	static constexpr int32 NumSlots = FTiltFiveWandInputState::NumSlots;
+
+	static int32 GetSlot(int32 PlayerIndex, int32 WandIndex) { return PlayerIndex * T5_MAX_NUM_CONTROLLER + WandIndex; }
+	static uint32 GetSlotBit(int32 Slot) { return 1u << Slot; }
+
+	FTiltFiveWandInputState Input;
+
+	uint32 HandleValidMask = 0;
+	FT5WandHandle Handles[NumSlots] = {};
+
 	// Wand pose in raw unreal coordinates, but unscaled relative to the world scale
-	TOptional<FTiltFiveWandPose> WandPose;
+	uint32 PoseValidMask = 0;
+	FTiltFiveWandPose Poses[NumSlots];
+
+	// Processed analog values, and the slots whose smoothing hasn't caught up with the raw values yet
+	FTiltFiveAnalogState AnalogStates[NumSlots];
+	uint32 AnalogSettlingMask = 0;
+
+	// Every button change since the events were last sent, in report order. A press and release within one frame cancel out in
+	// Input, these keep them apart.
+	uint32 ButtonTransitionMask = 0;
+	TArray<FTiltFiveWandButtonTransition> ButtonTransitions;
+
+	bool IsConnected(int32 Slot) const { return (Input.ConnectedMask & GetSlotBit(Slot)) != 0; }
+	bool HasHandle(int32 Slot) const { return (HandleValidMask & GetSlotBit(Slot)) != 0; }
+	bool HasPose(int32 Slot) const { return (PoseValidMask & GetSlotBit(Slot)) != 0; }
+
+	void SetConnected(int32 Slot, bool bConnected);
+	void SetHandle(int32 Slot, const TOptional<FT5WandHandle>& Handle);
 
-	TOptional<FT5WandHandle> WandHandle;
+	/** Forgets everything about the wands of a player, e.g. when their glasses change. */
+	void ResetPlayer(int32 PlayerIndex);
 
-	bool HasInputChanged(const FTiltFiveControllerState& Other) const;
-	void InitFromReport(const FT5WandReport& Report);
-	void UpdateFromState(const FTiltFiveControllerState& NewState);
+	/** Returns the index of the wand of the player with the given handle, INDEX_NONE if there is none. */
+	int32 FindWand(int32 PlayerIndex, FT5WandHandle Handle) const;
+
+	/** Takes over whatever parts of the report are valid. The time is when the wand made the report, see FTiltFiveButtonEdge. */
+	void ApplyReport(int32 Slot, const FT5WandReport& Report, double TimeSeconds, uint64 TimestampNanos);
 };
 
-#define T5_MAX_NUM_CONTROLLER (2)
+/** Wand stream state of one pair of glasses, kept separately for every player. */
+struct FTiltFiveGlassesInputState
+{
+	// The exclusive glasses the wand states of this player belong to
+	FT5GlassesPtr Glasses = nullptr;
+
+	// Set when the connected wands have to be listed again, i.e. for new glasses and whenever a wand connects
+	bool bWandListDirty = true;
+
+	// FPlatformTime::Cycles64() when the last wand event of these glasses was read, 0 if none was yet
+	uint64 LastEventHostCycles = 0;
+
+	// Estimated FPlatformTime::Seconds() minus service time, to place wand reports on our clock
+	bool bHasClockOffset = false;
+	double ClockOffsetSeconds = 0.0;
+};
 
 /**
  * Implements the regular unreal input interface and the motion controller for the tilt five wand
@@ -60,7 +144,8 @@ class FTiltFiveInputDevice : public IInputDevice, public FXRMotionControllerBase
 {
 public:
 	FTiltFiveInputDevice(const TSharedPtr<FTiltFiveXRBase, ESPMode::ThreadSafe>& HMD,
-		const TSharedRef<FGenericApplicationMessageHandler>& MessageHandler);
+		const TSharedRef<FGenericApplicationMessageHandler>& MessageHandler,
+		FTiltFiveInputTimeline& InputTimeline);
 	virtual ~FTiltFiveInputDevice();
 
 	// IInputDevice
@@ -115,15 +200,31 @@ public:
 private:
 	TSharedPtr<FTiltFiveXRBase, ESPMode::ThreadSafe> HMD;
 	TSharedRef<FGenericApplicationMessageHandler> MessageHandler;
+	FTiltFiveInputTimeline& InputTimeline;
+
+	FTiltFiveWandStateStore WandStates;
+	FTiltFiveGlassesInputState GlassesInputStates[FTiltFiveWandInputState::NumPlayers];
 
-	FTiltFiveControllerState WandStates[4][T5_MAX_NUM_CONTROLLER];
+	// Force feedback channels as last set for every player
+	FForceFeedbackValues ForceFeedbackValues[FTiltFiveWandInputState::NumPlayers];
+
+	void ListConnectedWands(const FTiltFiveHMD& Hmd, FT5GlassesPtr Glasses);
+	void SendForceFeedback(int32 PlayerIndex);
+
+	/** Queues a haptic impulse for the wand, to be sent by the haptics thread of the player's glasses. */
+	void RequestImpulse(int32 PlayerIndex, int32 WandIndex, float Amplitude, uint32 DurationMilliseconds);
+	void SendWandEvents(int32 PlayerIndex,
+		int32 WandIndex,
+		const FTiltFiveWandInputState& OldInput,
+		const FTiltFiveAnalogSettings& AnalogSettings);
+
+	/** Pose and velocities of the wand behind a motion source at the given time, from the pose history of its glasses. */
+	bool SampleWandMotion(const int32 ControllerIndex, const FName MotionSource, double TimeSeconds, struct FTiltFiveWandMotion& OutMotion) const;
 	void SendAxisKeysEvent(float OldValue,
 		float NewValue,
 		bool bPositiveAxis,
 		const FKey& Key,
 		float AxisButtonTriggerThreshold,
 		int32 ControllerIndex) const;
-
-	FT5GlassesPtr ConfiguredInputGlasses = nullptr;
 };
 ;
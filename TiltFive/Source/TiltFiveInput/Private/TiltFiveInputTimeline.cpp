@@ -0,0 +1,77 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "TiltFiveInputTimeline.h"
+
+FTiltFiveInputTimeline::FTiltFiveInputTimeline()
+{
+	Edges.SetNum(Capacity);
+}
+
+void FTiltFiveInputTimeline::Add(const FTiltFiveButtonEdge& Edge)
+{
+	check(IsInGameThread());
+
+	Edges[NumEdges % Capacity] = Edge;
+	++NumEdges;
+}
+
+bool FTiltFiveInputTimeline::GetLastPressTime(int32 PlayerIndex, const FKey& Key, double& OutTimeSeconds) const
+{
+	const FTiltFiveButtonEdge* Edge = FindLatest(PlayerIndex, Key, true);
+	OutTimeSeconds = Edge ? Edge->TimeSeconds : 0.0;
+	return Edge != nullptr;
+}
+
+bool FTiltFiveInputTimeline::GetLastReleaseTime(int32 PlayerIndex, const FKey& Key, double& OutTimeSeconds) const
+{
+	const FTiltFiveButtonEdge* Edge = FindLatest(PlayerIndex, Key, false);
+	OutTimeSeconds = Edge ? Edge->TimeSeconds : 0.0;
+	return Edge != nullptr;
+}
+
+int32 FTiltFiveInputTimeline::GetEdgesSince(double TimeSeconds, TArray<FTiltFiveButtonEdge>& OutEdges) const
+{
+	check(IsInGameThread());
+
+	// Edges are added in dispatch order, which is only ordered by time per wand, so look at all of them
+	const uint64 NumStored = FMath::Min<uint64>(NumEdges, Capacity);
+	int32 NumAppended = 0;
+	for (uint64 Index = NumEdges - NumStored; Index < NumEdges; ++Index)
+	{
+		const FTiltFiveButtonEdge& Edge = Edges[Index % Capacity];
+		if (Edge.TimeSeconds > TimeSeconds)
+		{
+			OutEdges.Add(Edge);
+			++NumAppended;
+		}
+	}
+	return NumAppended;
+}
+
+const FTiltFiveButtonEdge* FTiltFiveInputTimeline::FindLatest(int32 PlayerIndex, const FKey& Key, bool bPressed) const
+{
+	check(IsInGameThread());
+
+	const uint64 NumStored = FMath::Min<uint64>(NumEdges, Capacity);
+	for (uint64 Age = 0; Age < NumStored; ++Age)
+	{
+		const FTiltFiveButtonEdge& Edge = Edges[(NumEdges - 1 - Age) % Capacity];
+		if (Edge.PlayerIndex == PlayerIndex && Edge.bPressed == bPressed && Edge.Key == Key)
+		{
+			return &Edge;
+		}
+	}
+	return nullptr;
+}
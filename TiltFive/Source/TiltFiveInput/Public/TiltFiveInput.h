@@ -18,6 +18,7 @@
 #include "IHapticDevice.h"
 #include "IInputDeviceModule.h"
 #include "Modules/ModuleManager.h"
+#include "TiltFiveInputTimeline.h"
 #include "XRMotionControllerBase.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTiltFiveInput, Log, All);
@@ -25,6 +26,11 @@ DECLARE_LOG_CATEGORY_EXTERN(LogTiltFiveInput, Log, All);
 class TILTFIVEINPUT_API FTiltFiveInputModule : public IInputDeviceModule
 {
 public:
+	static FTiltFiveInputModule& Get()
+	{
+		return FModuleManager::Get().LoadModuleChecked<FTiltFiveInputModule>("TiltFiveInput");
+	}
+
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
@@ -32,5 +38,9 @@ public:
 	virtual TSharedPtr<class IInputDevice> CreateInputDevice(
 		const TSharedRef<FGenericApplicationMessageHandler>& InMessageHandler) override;
 
+	/** Recent wand button presses and releases, game thread only. */
+	const FTiltFiveInputTimeline& GetInputTimeline() const { return InputTimeline; }
+
 private:
+	FTiltFiveInputTimeline InputTimeline;
 };
@@ -51,6 +51,15 @@ class TILTFIVEINPUT_API UTiltFiveInputBlueprintLibrary : public UBlueprintFuncti
 	UFUNCTION(BlueprintCallable, Category = "Tilt Five|Input")
 	static bool UnregisterTiltFiveNavigation();
 
+	// Seconds since the player last pressed the wand button, measured from when the wand reported the press rather than from
+	// the frame it was dispatched in. Returns false if the button wasn't pressed recently.
+	UFUNCTION(BlueprintPure, Category = "Tilt Five|Input")
+	static bool GetWandButtonPressAge(int32 PlayerIndex, FKey Key, float& SecondsAgo);
+
+	// Seconds since the player last released the wand button, see GetWandButtonPressAge
+	UFUNCTION(BlueprintPure, Category = "Tilt Five|Input")
+	static bool GetWandButtonReleaseAge(int32 PlayerIndex, FKey Key, float& SecondsAgo);
+
 private:
 	static TSharedPtr<FNavigationConfig> OriginalNavigation;
 	static TSharedPtr<FTiltFiveNavigationConfig> TiltFiveNavigation;
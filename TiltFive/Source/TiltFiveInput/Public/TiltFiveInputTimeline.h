@@ -0,0 +1,66 @@
+// Copyright 2022 Tilt Five, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InputCoreTypes.h"
+
+/** A single press or release of a wand button. */
+struct FTiltFiveButtonEdge
+{
+	int32 PlayerIndex = INDEX_NONE;
+	FKey Key;
+	bool bPressed = false;
+
+	// When the wand reported the change, on the FPlatformTime::Seconds() clock
+	double TimeSeconds = 0.0;
+
+	// The same time as reported by the service, 0 for edges that didn't come from a wand report (e.g. the glasses going away)
+	uint64 TimestampNanos = 0;
+};
+
+/**
+ * Recent wand button presses and releases with the time the wand reported them, rather than the frame they were dispatched in.
+ *
+ * Lets gameplay judge input timing below the frame time, e.g. for rhythm games. Only touched on the game thread.
+ */
+class TILTFIVEINPUT_API FTiltFiveInputTimeline
+{
+public:
+	// Number of edges kept around. Enough for well over a second of button mashing on every wand.
+	static constexpr int32 Capacity = 256;
+
+	FTiltFiveInputTimeline();
+
+	void Add(const FTiltFiveButtonEdge& Edge);
+
+	/** Time of the most recent press of the key by the player. Returns false if there was none recently. */
+	bool GetLastPressTime(int32 PlayerIndex, const FKey& Key, double& OutTimeSeconds) const;
+
+	/** Time of the most recent release of the key by the player. Returns false if there was none recently. */
+	bool GetLastReleaseTime(int32 PlayerIndex, const FKey& Key, double& OutTimeSeconds) const;
+
+	/** Appends all edges reported after TimeSeconds, in the order they were dispatched. Returns the number of edges appended. */
+	int32 GetEdgesSince(double TimeSeconds, TArray<FTiltFiveButtonEdge>& OutEdges) const;
+
+	/** Total number of edges added so far. */
+	uint64 GetNumEdges() const { return NumEdges; }
+
+private:
+	const FTiltFiveButtonEdge* FindLatest(int32 PlayerIndex, const FKey& Key, bool bPressed) const;
+
+	TArray<FTiltFiveButtonEdge> Edges;
+	uint64 NumEdges = 0;
+};